@@ -3,6 +3,13 @@
 #include <cassert>
 #include <string>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <sstream>
 
 // DOCTEST NOTES
 //
@@ -138,10 +145,19 @@ public:
     }
 };
 
+template<typename T>
+class ListStack;
+
+template<typename T>
+void deserialize(std::istream & in, ListStack<T> & stack);
+
 template<typename T>
 class ListStack : public StackADT<T> {
 private: // other classes and programs cant access/use this. Thats what private means
     Node<T>* top; // last item of my linked list, the * means the variable is a pointer THIS MEANS TOP IS A POINTER.
+
+    // Loading builds the chain top down, so it links nodes directly instead of pushing.
+    friend void deserialize<T>(std::istream & in, ListStack<T> & stack);
 public: //other classes can!
     ListStack() : top(nullptr) {}
     ~ListStack() {
@@ -200,6 +216,14 @@ public: //other classes can!
         return {topValue};
     }
 
+    // Calls visit on every value from the top of the stack down without changing it.
+    template<typename Visit>
+    void forEachFromTop(Visit visit) const {
+        for (Node<T>* current = top; current != nullptr; current = current->getNext()) {
+            visit(current->getValue());
+        }
+    }
+
     bool pop() override {
         if(isEmpty()) {
             return false;
@@ -241,6 +265,287 @@ TEST_CASE("testing the linked chain implementation of stack") {
     CHECK(stack2.peek() == 3);
 }
 
+// ***** BINARY SERIALIZATION *****
+
+// Every stream starts with an 8 byte header: a magic string, a format version, the writer's byte
+// order, the kind of container and a reserved byte. Values are written in the writer's own byte
+// order, so a reader on the same kind of machine copies them straight into place and only a reader
+// on the other kind swaps bytes.
+constexpr char SERIAL_MAGIC[4] = {'D', 'S', 'B', 'F'};
+constexpr std::uint8_t SERIAL_VERSION = 1;
+constexpr std::uint8_t SERIAL_LITTLE_ENDIAN = 1;
+constexpr std::uint8_t SERIAL_BIG_ENDIAN = 2;
+// Lengths and counts come from the data, so readers allocate for at most this many bytes ahead of
+// what they have actually read.
+constexpr std::size_t SERIAL_CHUNK_BYTES = 1 << 16;
+
+enum class SerialKind : std::uint8_t {
+    List = 1,
+    Stack = 2,
+    Tree = 3
+};
+
+inline std::uint8_t hostByteOrder() {
+    const std::uint16_t probe = 1;
+    std::uint8_t firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 1 ? SERIAL_LITTLE_ENDIAN : SERIAL_BIG_ENDIAN;
+}
+
+// The size recorded for an entry type so a reader can refuse data written for another type.
+// Strings are length prefixed and recorded as 0.
+template<class V>
+std::uint32_t serialElementSize() {
+    if constexpr (std::is_same_v<V, std::string>) {
+        return 0;
+    } else {
+        static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable entries and strings can be serialized.");
+        return sizeof(V);
+    }
+}
+
+// Streams values to out behind the header for one container.
+class BinaryWriter {
+private:
+    std::ostream &out;
+
+public:
+    BinaryWriter(std::ostream &out, SerialKind kind) : out(out) {
+        out.write(SERIAL_MAGIC, sizeof(SERIAL_MAGIC));
+        write(SERIAL_VERSION);
+        write(hostByteOrder());
+        write(static_cast<std::uint8_t>(kind));
+        write(std::uint8_t{0}); // reserved, pads the header to 8 bytes
+    }
+
+    template<class V>
+    void write(const V &value) {
+        static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable entries and strings can be serialized.");
+        out.write(reinterpret_cast<const char *>(&value), sizeof(V));
+    }
+
+    void write(const std::string &value) {
+        write<std::uint64_t>(value.size());
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    // Writes count values, as one block when they are trivially copyable.
+    template<class V>
+    void writeArray(const V *values, std::size_t count) {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(V)));
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                write(values[i]);
+            }
+        }
+    }
+
+    template<class V>
+    void writeElementSize() {
+        write(serialElementSize<V>());
+    }
+
+    void finish() {
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Writing serialized data failed.");
+        }
+    }
+};
+
+// Reads values back from in after checking the header. Data that is cut short, of another kind or
+// written for another entry type throws std::runtime_error.
+class BinaryReader {
+private:
+    std::istream &in;
+    bool swapBytes;
+
+    void readBytes(void *destination, std::size_t count) {
+        in.read(static_cast<char *>(destination), static_cast<std::streamsize>(count));
+        if (static_cast<std::size_t>(in.gcount()) != count) {
+            throw std::runtime_error("Serialized data ends early.");
+        }
+    }
+
+    template<class V>
+    static void swapByteOrder(V &value) {
+        if constexpr (std::is_arithmetic_v<V> || std::is_enum_v<V>) {
+            char *bytes = reinterpret_cast<char *>(&value);
+            std::reverse(bytes, bytes + sizeof(V));
+        } else if constexpr (sizeof(V) > 1) {
+            throw std::runtime_error("Cannot change the byte order of a compound entry.");
+        }
+    }
+
+public:
+    BinaryReader(std::istream &in, SerialKind kind) : in(in), swapBytes(false) {
+        char magic[sizeof(SERIAL_MAGIC)];
+        readBytes(magic, sizeof(magic));
+        if (std::memcmp(magic, SERIAL_MAGIC, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not serialized container data.");
+        }
+        if (read<std::uint8_t>() != SERIAL_VERSION) {
+            throw std::runtime_error("Unsupported serialization version.");
+        }
+        std::uint8_t byteOrder = read<std::uint8_t>();
+        if (byteOrder != SERIAL_LITTLE_ENDIAN && byteOrder != SERIAL_BIG_ENDIAN) {
+            throw std::runtime_error("Unknown byte order in serialized data.");
+        }
+        swapBytes = byteOrder != hostByteOrder();
+        if (read<std::uint8_t>() != static_cast<std::uint8_t>(kind)) {
+            throw std::runtime_error("Serialized data holds a different kind of container.");
+        }
+        read<std::uint8_t>();
+    }
+
+    template<class V>
+    V read() {
+        V value{};
+        readInto(value);
+        return value;
+    }
+
+    template<class V>
+    void readInto(V &value) {
+        readBytes(&value, sizeof(V));
+        if (swapBytes) {
+            swapByteOrder(value);
+        }
+    }
+
+    // Grows the string as its bytes arrive, so a corrupt length runs out of input instead of
+    // allocating memory up front.
+    void readInto(std::string &value) {
+        std::uint64_t length = read<std::uint64_t>();
+        if (length > value.max_size()) {
+            throw std::runtime_error("Serialized string is too long.");
+        }
+        value.clear();
+        while (value.size() < length) {
+            std::size_t start = value.size();
+            std::size_t step = static_cast<std::size_t>(std::min<std::uint64_t>(length - start, SERIAL_CHUNK_BYTES));
+            value.resize(start + step);
+            readBytes(&value[start], step);
+        }
+    }
+
+    // Reads count values straight into contiguous storage, as one block when they are trivially
+    // copyable.
+    template<class V>
+    void readArray(V *values, std::size_t count) {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            readBytes(values, count * sizeof(V));
+            if (swapBytes) {
+                for (std::size_t i = 0; i < count; i++) {
+                    swapByteOrder(values[i]);
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                readInto(values[i]);
+            }
+        }
+    }
+
+    template<class V>
+    void expectElementSize() {
+        if (read<std::uint32_t>() != serialElementSize<V>()) {
+            throw std::runtime_error("Serialized data holds a different entry type.");
+        }
+    }
+
+    // Reads an entry count and checks it fits in an int.
+    int readCount() {
+        std::uint64_t count = read<std::uint64_t>();
+        if (count > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("Serialized entry count is too large.");
+        }
+        return static_cast<int>(count);
+    }
+};
+
+// A stack is written as its entry size, its depth and then its entries from the top down.
+template<typename T>
+void serialize(std::ostream & out, const ListStack<T> & stack) {
+    BinaryWriter writer(out, SerialKind::Stack);
+    writer.writeElementSize<T>();
+    std::uint64_t depth = 0;
+    stack.forEachFromTop([&depth](const T &) { depth++; });
+    writer.write(depth);
+    stack.forEachFromTop([&writer](const T & value) { writer.write(value); });
+    writer.finish();
+}
+
+// Replaces the contents of stack with the serialized entries. The stack is unchanged if reading
+// fails.
+template<typename T>
+void deserialize(std::istream & in, ListStack<T> & stack) {
+    BinaryReader reader(in, SerialKind::Stack);
+    reader.expectElementSize<T>();
+    int depth = reader.readCount();
+    ListStack<T> loaded;
+    Node<T>* bottom = nullptr;
+    for (int i = 0; i < depth; i++) {
+        Node<T>* node = new Node<T>(reader.read<T>());
+        if (bottom == nullptr) {
+            loaded.top = node;
+        } else {
+            bottom->setNext(node);
+        }
+        bottom = node;
+    }
+    std::swap(stack.top, loaded.top);
+}
+
+TEST_CASE("testing binary serialization of the linked chain stack") {
+    ListStack<int> stack0;
+    for (int i = 1; i <= 1000; i++) {
+        stack0.push(i * i);
+    }
+    std::stringstream stream;
+    serialize(stream, stack0);
+
+    ListStack<int> stack1;
+    stack1.push(-1);
+    deserialize(stream, stack1);
+    bool allMatch = true;
+    for (int i = 1000; i >= 1; i--) {
+        allMatch = allMatch && !stack1.isEmpty() && stack1.peek() == i * i;
+        stack1.pop();
+    }
+    CHECK(allMatch);
+    CHECK(stack1.isEmpty());
+
+    ListStack<string> braces;
+    braces.push("{");
+    braces.push("}");
+    std::stringstream braceStream;
+    serialize(braceStream, braces);
+    ListStack<string> loadedBraces;
+    deserialize(braceStream, loadedBraces);
+    CHECK(loadedBraces.peek() == "}");
+    CHECK(loadedBraces.pop());
+    CHECK(loadedBraces.peek() == "{");
+
+    // Cut short or mismatched data throws and leaves the stack alone.
+    stack1.push(5);
+    std::stringstream truncated(stream.str().substr(0, 40));
+    CHECK_THROWS_AS(deserialize(truncated, stack1), std::runtime_error);
+    CHECK(stack1.peek() == 5);
+    std::stringstream wrongType(stream.str());
+    ListStack<double> doubles;
+    CHECK_THROWS_AS(deserialize(wrongType, doubles), std::runtime_error);
+
+    // A corrupt string length runs out of data instead of allocating for it.
+    std::string hugeString = braceStream.str();
+    std::uint64_t hugeLength = std::uint64_t{1} << 62;
+    std::memcpy(&hugeString[20], &hugeLength, sizeof(hugeLength));
+    std::stringstream hugeStringStream(hugeString);
+    CHECK_THROWS_AS(deserialize(hugeStringStream, loadedBraces), std::runtime_error);
+    CHECK(loadedBraces.peek() == "{");
+}
+
 bool areCurleyBracesMatched(const string & inputString) {
     ListStack<string> fakeStack;
     for (int i=0; i < inputString.length(); i++){
@@ -2,6 +2,15 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
 
 const char queenChar = 'Q';
 // Function that displays the chess board. we use - to "make it"
@@ -63,11 +72,239 @@ bool solveEightQueens(std::vector<std::string>& board, int column, int numberOfQ
            
         }
     }
+    return false;
 }
 
-int main() {
+// ***** COUNTING ALL SOLUTIONS *****
+//
+// solveEightQueens stops at the first solution and isSafe rescans the board for every square.
+// To count every solution for larger boards we keep the attacked columns and diagonals of the
+// current row as bitmasks instead, so trying a square is a couple of bit operations.
+
+constexpr int MAX_COUNTED_QUEENS = 32;
+
+using QueenMask = std::uint64_t;
+
+// Counts the ways to finish a board whose first `row` rows already hold a queen. cols,
+// leftDiagonals and rightDiagonals mark the squares of `row` that are attacked.
+long long countQueensFrom(int row, int numberOfQueens, QueenMask cols, QueenMask leftDiagonals, QueenMask rightDiagonals) {
+    if (row == numberOfQueens) {
+        return 1;
+    }
+
+    const QueenMask fullRow = (QueenMask{1} << numberOfQueens) - 1;
+    QueenMask available = fullRow & ~(cols | leftDiagonals | rightDiagonals);
+    long long count = 0;
+    while (available != 0) {
+        QueenMask square = available & (~available + 1); // lowest free square
+        available ^= square;
+        count += countQueensFrom(row + 1, numberOfQueens, cols | square,
+                                 (leftDiagonals | square) << 1, (rightDiagonals | square) >> 1);
+    }
+    return count;
+}
+
+void checkCountedQueens(int numberOfQueens) {
+    if (numberOfQueens < 1 || numberOfQueens > MAX_COUNTED_QUEENS) {
+        throw std::invalid_argument("Number of queens must be between 1 and 32.");
+    }
+}
+
+// Single threaded count of every solution, used as the reference for the parallel version.
+long long countQueensSolutions(int numberOfQueens) {
+    checkCountedQueens(numberOfQueens);
+    return countQueensFrom(0, numberOfQueens, 0, 0, 0);
+}
+
+// A partial board covering the first `row` rows. Every solution below it stands for `weight`
+// solutions of the full problem (2 when its mirror image is skipped).
+struct QueensTask {
+    int row;
+    QueenMask cols;
+    QueenMask leftDiagonals;
+    QueenMask rightDiagonals;
+    long long weight;
+};
+
+// Places one more queen on every free square of task's next row. Only squares left of
+// columnLimit are tried.
+void expandQueensTask(const QueensTask& task, int columnLimit, std::vector<QueensTask>& out) {
+    for (int column = 0; column < columnLimit; ++column) {
+        QueenMask square = QueenMask{1} << column;
+        if ((task.cols | task.leftDiagonals | task.rightDiagonals) & square) {
+            continue;
+        }
+        out.push_back(QueensTask{task.row + 1, task.cols | square,
+                                 (task.leftDiagonals | square) << 1, (task.rightDiagonals | square) >> 1,
+                                 task.weight});
+    }
+}
+
+// Splits the search tree on its first splitDepth rows. Mirroring a board left to right maps
+// solutions onto solutions, so the first queen only goes in the left half and each result counts
+// twice. With an odd board the first queen may also sit in the middle column; then the second
+// queen, which can never share that column, is kept to the left half instead.
+std::vector<QueensTask> splitQueensSearch(int numberOfQueens, int splitDepth) {
+    std::vector<QueensTask> tasks;
+    const QueensTask emptyBoard{0, 0, 0, 0, 2};
+    expandQueensTask(emptyBoard, numberOfQueens / 2, tasks);
+    if (numberOfQueens % 2 == 1) {
+        std::vector<QueensTask> middle;
+        const QueenMask square = QueenMask{1} << (numberOfQueens / 2);
+        expandQueensTask(QueensTask{1, square, square << 1, square >> 1, 2}, numberOfQueens / 2, middle);
+        tasks.insert(tasks.end(), middle.begin(), middle.end());
+    }
+
+    std::vector<QueensTask> split;
+    for (const QueensTask& task : tasks) {
+        std::vector<QueensTask> frontier{task};
+        while (frontier.front().row < splitDepth) {
+            std::vector<QueensTask> next;
+            for (const QueensTask& partial : frontier) {
+                expandQueensTask(partial, numberOfQueens, next);
+            }
+            if (next.empty()) {
+                break; // dead end, counting it again finds nothing
+            }
+            frontier.swap(next);
+        }
+        split.insert(split.end(), frontier.begin(), frontier.end());
+    }
+    return split;
+}
+
+// A fixed set of worker threads, each with its own deque of tasks. A worker takes tasks from the
+// back of its own deque and, once that runs dry, steals from the front of the other deques, so a
+// worker that drew cheap subtrees helps out with the expensive ones.
+template<typename Task>
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<WorkerQueue> queues;
+
+    bool popOwn(size_t worker, Task& task) {
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        if (queues[worker].tasks.empty()) {
+            return false;
+        }
+        task = queues[worker].tasks.back();
+        queues[worker].tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task) {
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& victim = queues[(thief + offset) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    explicit WorkStealingPool(size_t workerCount) : queues(workerCount) {
+        if (workerCount == 0) {
+            throw std::invalid_argument("A pool needs at least one worker.");
+        }
+    }
+
+    size_t workerCount() const {
+        return queues.size();
+    }
+
+    // Queues a task on the given worker's deque. Tasks are submitted before run is called.
+    void submit(size_t worker, const Task& task) {
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        queues[worker].tasks.push_back(task);
+    }
+
+    // Runs work on every queued task and returns once all of them are done.
+    template<typename Work>
+    void run(Work work) {
+        std::vector<std::thread> threads;
+        for (size_t worker = 0; worker < queues.size(); ++worker) {
+            threads.emplace_back([this, worker, &work]() {
+                Task task;
+                while (popOwn(worker, task) || steal(worker, task)) {
+                    work(task);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+// Counts every solution using threadCount workers. The first three rows are split into tasks,
+// which gives a few hundred to a few thousand subtrees for the boards where this matters.
+long long countQueensSolutionsParallel(int numberOfQueens, size_t threadCount) {
+    checkCountedQueens(numberOfQueens);
+    if (numberOfQueens == 1) {
+        return 1;
+    }
+
+    const int splitDepth = std::min(3, numberOfQueens);
+    std::vector<QueensTask> tasks = splitQueensSearch(numberOfQueens, splitDepth);
+
+    WorkStealingPool<QueensTask> pool(threadCount);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        pool.submit(i % pool.workerCount(), tasks[i]);
+    }
+
+    std::atomic<long long> total{0};
+    pool.run([numberOfQueens, &total](const QueensTask& task) {
+        long long count = countQueensFrom(task.row, numberOfQueens, task.cols, task.leftDiagonals, task.rightDiagonals);
+        total.fetch_add(task.weight * count, std::memory_order_relaxed);
+    });
+    return total.load();
+}
+
+// Times the parallel count for 1, 2, 4, ... threads up to the number of cores.
+void reportQueensScaling(int numberOfQueens) {
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    std::cout << "Counting " << numberOfQueens << " queens solutions" << std::endl;
+    double singleThreadSeconds = 0.0;
+    for (size_t threads : threadCounts) {
+        auto start = std::chrono::steady_clock::now();
+        long long solutions = countQueensSolutionsParallel(numberOfQueens, threads);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double seconds = std::max(elapsed.count(), 1e-9);
+        if (threads == 1) {
+            singleThreadSeconds = seconds;
+        }
+        std::cout << threads << " threads: " << solutions << " solutions in " << seconds << " s, "
+                  << solutions / seconds << " solutions/sec, speedup "
+                  << singleThreadSeconds / seconds << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
     const int numberOfQueens = 8; // For the 8 Queens problem
     std::vector<std::string> board(numberOfQueens, std::string(numberOfQueens, '-')); // Initialize empty board // creates the board
     solveEightQueens(board, 0, numberOfQueens);
+
+    // Pass a board size to count all of its solutions, e.g. ./main_8queens 16
+    const int countedQueens = argc > 1 ? std::atoi(argv[1]) : 12;
+    try {
+        reportQueensScaling(countedQueens);
+    } catch (const std::invalid_argument& error) {
+        std::cerr << "Cannot count solutions for \"" << argv[1] << "\": " << error.what() << std::endl;
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,393 @@
+// A reusable backtracking engine for constraint satisfaction problems, generalized from
+// solveEightQueens in main_8queens.cpp.
+//
+// solveEightQueens hard codes its puzzle: isSafe rescans the board for every square and the
+// search recurses one column at a time. Here a problem is a set of variables with small integer
+// domains plus pluggable constraints. Domains are bitmasks that constraints prune as variables
+// get assigned (forward checking), every change is recorded on a trail so backtracking only
+// undoes what changed, the next variable is picked by minimum remaining values with the
+// constraint degree as tie break, and the search runs on an explicit stack instead of recursion.
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// The values still possible for a variable, one bit per value.
+using Domain = std::uint64_t;
+
+constexpr int MAX_DOMAIN_SIZE = 64;
+
+// Domains, assignments and the undo trail shared by the solver and its constraints.
+class DomainStore {
+private:
+    std::vector<Domain> domains;
+    std::vector<int> assignment; // -1 while unassigned
+    std::vector<std::pair<int, Domain>> trail; // variable and its domain before a change
+    int assignedCount;
+
+    // The domain holding values 0 .. domainSize - 1. Checked here because the member initializers
+    // shift by domainSize before the constructor body could reject it.
+    static Domain fullDomain(int domainSize) {
+        if (domainSize < 1 || domainSize > MAX_DOMAIN_SIZE) {
+            throw std::invalid_argument("Domain size must be between 1 and 64.");
+        }
+        return domainSize == MAX_DOMAIN_SIZE ? ~Domain{0} : (Domain{1} << domainSize) - 1;
+    }
+
+public:
+    DomainStore(int variableCount, int domainSize)
+            : domains(variableCount, fullDomain(domainSize)), assignment(variableCount, -1), assignedCount(0) {}
+
+    int variableCount() const {
+        return static_cast<int>(domains.size());
+    }
+
+    Domain domain(int variable) const {
+        return domains[variable];
+    }
+
+    bool isAssigned(int variable) const {
+        return assignment[variable] != -1;
+    }
+
+    int valueOf(int variable) const {
+        return assignment[variable];
+    }
+
+    const std::vector<int>& values() const {
+        return assignment;
+    }
+
+    bool isComplete() const {
+        return assignedCount == variableCount();
+    }
+
+    // Narrows a domain to the values in mask. Returns false if nothing is left.
+    bool restrict(int variable, Domain mask) {
+        Domain narrowed = domains[variable] & mask;
+        if (narrowed != domains[variable]) {
+            trail.emplace_back(variable, domains[variable]);
+            domains[variable] = narrowed;
+        }
+        return narrowed != 0;
+    }
+
+    bool removeValue(int variable, int value) {
+        return restrict(variable, ~(Domain{1} << value));
+    }
+
+    void assign(int variable, int value) {
+        restrict(variable, Domain{1} << value);
+        assignment[variable] = value;
+        ++assignedCount;
+    }
+
+    void unassign(int variable) {
+        if (assignment[variable] != -1) {
+            assignment[variable] = -1;
+            --assignedCount;
+        }
+    }
+
+    size_t trailMark() const {
+        return trail.size();
+    }
+
+    // Restores every domain changed since the trail had the given size.
+    void undoTo(size_t mark) {
+        while (trail.size() > mark) {
+            domains[trail.back().first] = trail.back().second;
+            trail.pop_back();
+        }
+    }
+};
+
+// A constraint over the variables in its scope. After one of them is assigned, propagate prunes
+// values of the other unassigned variables that can no longer be part of a solution and returns
+// false if some domain is wiped out.
+class Constraint {
+public:
+    virtual const std::vector<int>& scope() const = 0;
+    virtual bool propagate(DomainStore& store, int variable, int value) const = 0;
+
+    virtual ~Constraint() = default;
+};
+
+// All variables in the scope take different values.
+class AllDifferentConstraint final : public Constraint {
+private:
+    std::vector<int> variables;
+
+public:
+    explicit AllDifferentConstraint(std::vector<int> variables) : variables(std::move(variables)) {}
+
+    const std::vector<int>& scope() const override {
+        return variables;
+    }
+
+    bool propagate(DomainStore& store, int variable, int value) const override {
+        for (int other : variables) {
+            if (other != variable && !store.isAssigned(other) && !store.removeValue(other, value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Any relation between two variables, given as a predicate on (value of first, value of second).
+class PairConstraint final : public Constraint {
+private:
+    std::vector<int> variables;
+    std::function<bool(int, int)> allowed;
+
+public:
+    PairConstraint(int first, int second, std::function<bool(int, int)> allowed)
+            : variables{first, second}, allowed(std::move(allowed)) {}
+
+    const std::vector<int>& scope() const override {
+        return variables;
+    }
+
+    bool propagate(DomainStore& store, int variable, int value) const override {
+        bool assignedFirst = variable == variables[0];
+        int other = assignedFirst ? variables[1] : variables[0];
+        if (store.isAssigned(other)) {
+            return true;
+        }
+
+        Domain keep = 0;
+        for (Domain candidates = store.domain(other); candidates != 0; candidates &= candidates - 1) {
+            int candidate = std::countr_zero(candidates);
+            if (assignedFirst ? allowed(value, candidate) : allowed(candidate, value)) {
+                keep |= Domain{1} << candidate;
+            }
+        }
+        return store.restrict(other, keep);
+    }
+};
+
+class ConstraintSolver {
+private:
+    DomainStore store;
+    std::vector<std::unique_ptr<Constraint>> constraints;
+    std::vector<std::vector<int>> constraintsOf; // indices into constraints, per variable
+
+    // One level of the explicit search stack: the variable chosen here, the values not yet tried
+    // and the trail size to return to before trying the next one.
+    struct Frame {
+        int variable;
+        Domain untried;
+        size_t trailMark;
+    };
+
+    // The number of constraints on variable that still involve some other unassigned variable.
+    int unassignedDegree(int variable) const {
+        int count = 0;
+        for (int index : constraintsOf[variable]) {
+            for (int other : constraints[index]->scope()) {
+                if (other != variable && !store.isAssigned(other)) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+        return count;
+    }
+
+    // Minimum remaining values, ties broken by the larger degree. The degree is only worked out
+    // for variables that can still win, since most lose on domain size alone.
+    int selectVariable() const {
+        int best = -1;
+        int bestSize = MAX_DOMAIN_SIZE + 1;
+        int bestDegree = -1;
+        for (int variable = 0; variable < store.variableCount(); ++variable) {
+            if (store.isAssigned(variable)) {
+                continue;
+            }
+            int size = std::popcount(store.domain(variable));
+            if (size > bestSize) {
+                continue;
+            }
+            int degree = unassignedDegree(variable);
+            if (size < bestSize || degree > bestDegree) {
+                best = variable;
+                bestSize = size;
+                bestDegree = degree;
+            }
+        }
+        return best;
+    }
+
+    bool assignAndPropagate(int variable, int value) {
+        store.assign(variable, value);
+        for (int index : constraintsOf[variable]) {
+            if (!constraints[index]->propagate(store, variable, value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    ConstraintSolver(int variableCount, int domainSize) : store(variableCount, domainSize), constraintsOf(variableCount) {
+        if (variableCount < 1) {
+            throw std::invalid_argument("A problem needs at least one variable.");
+        }
+    }
+
+    void addConstraint(std::unique_ptr<Constraint> constraint) {
+        for (int variable : constraint->scope()) {
+            constraintsOf.at(variable).push_back(static_cast<int>(constraints.size()));
+        }
+        constraints.push_back(std::move(constraint));
+    }
+
+    // Pins a variable to one value before solving, e.g. the givens of a Sudoku.
+    void fixValue(int variable, int value) {
+        if (!store.restrict(variable, Domain{1} << value)) {
+            throw std::invalid_argument("Fixed value is not in the variable's domain.");
+        }
+    }
+
+    // Searches for solutions, calling onSolution with the values of every variable, and stops
+    // after solutionLimit of them. Returns how many were found.
+    long long solve(long long solutionLimit, const std::function<void(const std::vector<int>&)>& onSolution) {
+        long long found = 0;
+        const size_t startMark = store.trailMark();
+        std::vector<Frame> frames;
+        int first = selectVariable();
+        frames.push_back(Frame{first, store.domain(first), store.trailMark()});
+
+        while (!frames.empty() && found < solutionLimit) {
+            Frame& frame = frames.back();
+            // Take back whatever the previous value tried at this level did.
+            store.undoTo(frame.trailMark);
+            store.unassign(frame.variable);
+            if (frame.untried == 0) {
+                frames.pop_back();
+                continue;
+            }
+
+            int value = std::countr_zero(frame.untried);
+            frame.untried &= frame.untried - 1;
+            int variable = frame.variable;
+            if (!assignAndPropagate(variable, value)) {
+                continue;
+            }
+
+            if (store.isComplete()) {
+                ++found;
+                onSolution(store.values());
+                continue;
+            }
+            int next = selectVariable();
+            frames.push_back(Frame{next, store.domain(next), store.trailMark()});
+        }
+
+        // Leave the store as it was so solve can run again.
+        while (!frames.empty()) {
+            store.unassign(frames.back().variable);
+            frames.pop_back();
+        }
+        store.undoTo(startMark);
+        return found;
+    }
+
+    long long countSolutions() {
+        return solve(std::numeric_limits<long long>::max(), [](const std::vector<int>&) {});
+    }
+};
+
+// ***** N-QUEENS *****
+
+// One variable per row holding the column of that row's queen.
+ConstraintSolver makeQueensProblem(int numberOfQueens) {
+    ConstraintSolver solver(numberOfQueens, numberOfQueens);
+    std::vector<int> rows;
+    for (int row = 0; row < numberOfQueens; ++row) {
+        rows.push_back(row);
+    }
+    solver.addConstraint(std::make_unique<AllDifferentConstraint>(rows));
+    for (int first = 0; first < numberOfQueens; ++first) {
+        for (int second = first + 1; second < numberOfQueens; ++second) {
+            int distance = second - first;
+            solver.addConstraint(std::make_unique<PairConstraint>(first, second, [distance](int a, int b) {
+                return a - b != distance && b - a != distance;
+            }));
+        }
+    }
+    return solver;
+}
+
+// ***** SUDOKU *****
+
+// One variable per cell holding its digit minus one. puzzle lists the 81 cells row by row with
+// '.' or '0' for blanks.
+ConstraintSolver makeSudokuProblem(const std::string& puzzle) {
+    if (puzzle.size() != 81) {
+        throw std::invalid_argument("A Sudoku puzzle has 81 cells.");
+    }
+
+    ConstraintSolver solver(81, 9);
+    for (int i = 0; i < 9; ++i) {
+        std::vector<int> row, column, box;
+        for (int j = 0; j < 9; ++j) {
+            row.push_back(i * 9 + j);
+            column.push_back(j * 9 + i);
+            box.push_back((i / 3 * 3 + j / 3) * 9 + i % 3 * 3 + j % 3);
+        }
+        solver.addConstraint(std::make_unique<AllDifferentConstraint>(row));
+        solver.addConstraint(std::make_unique<AllDifferentConstraint>(column));
+        solver.addConstraint(std::make_unique<AllDifferentConstraint>(box));
+    }
+    for (int cell = 0; cell < 81; ++cell) {
+        if (puzzle[cell] >= '1' && puzzle[cell] <= '9') {
+            solver.fixValue(cell, puzzle[cell] - '1');
+        }
+    }
+    return solver;
+}
+
+// ***** BENCHMARK *****
+
+template<typename Work>
+double secondsToRun(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main() {
+    for (int numberOfQueens = 4; numberOfQueens <= 12; ++numberOfQueens) {
+        ConstraintSolver solver = makeQueensProblem(numberOfQueens);
+        long long solutions = 0;
+        double seconds = secondsToRun([&]() { solutions = solver.countSolutions(); });
+        std::cout << numberOfQueens << " queens: " << solutions << " solutions in " << seconds << " s" << std::endl;
+    }
+
+    // Arto Inkala's "world's hardest Sudoku".
+    const std::string puzzle = "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..";
+    ConstraintSolver sudoku = makeSudokuProblem(puzzle);
+    std::string answer;
+    double seconds = secondsToRun([&]() {
+        sudoku.solve(1, [&answer](const std::vector<int>& values) {
+            for (int value : values) {
+                answer += static_cast<char>('1' + value);
+            }
+        });
+    });
+    std::cout << "Sudoku solved in " << seconds << " s" << std::endl;
+    for (int row = 0; row < 9; ++row) {
+        std::cout << answer.substr(row * 9, 9) << std::endl;
+    }
+    return 0;
+}
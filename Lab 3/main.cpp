@@ -2,6 +2,32 @@
 #include <string>
 #include <stdexcept>
 #include <memory>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <cstring>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <atomic>
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <filesystem>
+#include <sstream>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // https://github.com/doctest/doctest/blob/master/doc/markdown/tutorial.md
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
@@ -31,13 +57,179 @@ template<typename T, int N>
 class ArrayList final : public ListADT<T> {
 private:
     int itemCount;
-    int maxItems;
-    int items[N]{};
+    int maxItems; // current capacity, grows as needed
+    std::unique_ptr<T[]> items;
+
+    // Makes room for at least `needed` items, doubling the capacity so appends stay amortized O(1).
+    void ensureCapacity(int needed) {
+        if (needed <= maxItems) {
+            return;
+        }
+        int newMaxItems = std::max(needed, maxItems * 2);
+        std::unique_ptr<T[]> newItems = std::make_unique<T[]>(newMaxItems);
+        std::move(items.get(), items.get() + itemCount, newItems.get());
+        items = std::move(newItems);
+        maxItems = newMaxItems;
+    }
+
+    // Moves the entries at indices >= fromIndex so the first of them lands at toIndex. Trivially
+    // copyable entries are moved with a single memmove.
+    void shiftItems(int fromIndex, int toIndex) {
+        T* first = items.get() + fromIndex;
+        T* last = items.get() + itemCount;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(items.get() + toIndex, first, (last - first) * sizeof(T));
+        } else if (toIndex > fromIndex) {
+            std::move_backward(first, last, last + (toIndex - fromIndex));
+        } else {
+            std::move(first, last, items.get() + toIndex);
+        }
+    }
+
+    // Resets entries that are no longer in the list so they let go of anything they own.
+    void releaseItems(int fromIndex, int toIndex) {
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            std::fill(items.get() + fromIndex, items.get() + toIndex, T{});
+        }
+    }
+
+    // Opens a gap at newPosition and copies [first, last), which must not be in this list, into it.
+    template<typename ForwardIterator>
+    void copyIntoGap(int newPosition, ForwardIterator first, ForwardIterator last) {
+        int count = static_cast<int>(std::distance(first, last));
+        ensureCapacity(itemCount + count);
+        shiftItems(newPosition - 1, newPosition - 1 + count);
+        std::copy(first, last, items.get() + newPosition - 1);
+        itemCount += count;
+    }
+
+    // Whether [first, last) is stored in this list's array. Only ranges of T lvalues can be.
+    template<typename ForwardIterator>
+    bool pointsIntoItems(ForwardIterator first, ForwardIterator last) const {
+        using Reference = decltype(*first);
+        if constexpr (std::is_lvalue_reference_v<Reference> &&
+                      std::is_same_v<std::remove_cv_t<std::remove_reference_t<Reference>>, T>) {
+            if (first == last) {
+                return false;
+            }
+            const T* entry = std::addressof(*first);
+            std::less<const T*> before; // a total order even for pointers into other arrays
+            return !before(entry, items.get()) && before(entry, items.get() + maxItems);
+        } else {
+            return false;
+        }
+    }
+
 public:
-    ArrayList() : itemCount(0), maxItems(N) {
+    ArrayList() : itemCount(0), maxItems(N), items(std::make_unique<T[]>(N)) {
         static_assert(N >= MAX_ARRAY_SIZE);
     }
 
+    // Builds the list from [first, last) with a single allocation and copy.
+    template<class ForwardIterator, class = typename std::iterator_traits<ForwardIterator>::iterator_category>
+    ArrayList(ForwardIterator first, ForwardIterator last) : ArrayList() {
+        insertRange(1, first, last);
+    }
+
+    // Builds a list of n entries where entry i (counting from 0) is generate(i).
+    template<class Generator>
+    static ArrayList fromGenerator(int n, Generator generate) {
+        ArrayList list;
+        list.resize(n);
+        for (int i = 0; i < n; i++) {
+            list.items[i] = generate(i);
+        }
+        return list;
+    }
+
+    ArrayList(const ArrayList &other) : itemCount(other.itemCount), maxItems(other.maxItems),
+                                        items(std::make_unique<T[]>(other.maxItems)) {
+        std::copy(other.items.get(), other.items.get() + other.itemCount, items.get());
+    }
+
+    ArrayList(ArrayList &&other) noexcept : itemCount(other.itemCount), maxItems(other.maxItems),
+                                            items(std::move(other.items)) {
+        other.itemCount = 0;
+        other.maxItems = 0;
+    }
+
+    ArrayList &operator=(ArrayList other) noexcept {
+        std::swap(itemCount, other.itemCount);
+        std::swap(maxItems, other.maxItems);
+        std::swap(items, other.items);
+        return *this;
+    }
+
+    // Entries are contiguous, so plain pointers serve as random access iterators.
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    iterator begin() {
+        return items.get();
+    }
+
+    iterator end() {
+        return items.get() + itemCount;
+    }
+
+    const_iterator begin() const {
+        return items.get();
+    }
+
+    const_iterator end() const {
+        return items.get() + itemCount;
+    }
+
+    // A position in the list that edits happen at. insert puts an entry before the cursor's entry
+    // and remove takes the cursor's entry out, leaving the cursor on the entry that followed.
+    class Cursor {
+    private:
+        ArrayList *list;
+        int index;
+
+    public:
+        Cursor(ArrayList &list, int position) : list(&list), index(position - 1) {}
+
+        bool hasEntry() const {
+            return index < list->itemCount;
+        }
+
+        int getPosition() const {
+            return index + 1;
+        }
+
+        T getEntry() const {
+            return list->getEntry(index + 1);
+        }
+
+        void replace(const T &newEntry) {
+            list->replace(index + 1, newEntry);
+        }
+
+        void advance() {
+            if (hasEntry()) {
+                index++;
+            }
+        }
+
+        void insert(const T &newEntry) {
+            list->insert(index + 1, newEntry);
+            index++;
+        }
+
+        bool remove() {
+            return list->remove(index + 1);
+        }
+    };
+
+    // Returns a cursor on the given position, which may be one past the last entry.
+    Cursor cursor(int position = 1) {
+        if (position < 1 || position > itemCount + 1) {
+            throw std::out_of_range("Position out of range.");
+        }
+        return Cursor(*this, position);
+    }
+
     bool isEmpty() const {
         return itemCount == 0;
     }
@@ -46,39 +238,87 @@ public:
         return itemCount;
     };
 
+    int getCapacity() const {
+        return maxItems;
+    }
+
+    void reserve(int capacity) {
+        ensureCapacity(capacity);
+    }
+
+    // Changes the length to newLength, dropping entries off the end or appending T{}.
+    void resize(int newLength) {
+        if (newLength < 0) {
+            throw std::invalid_argument("resize() called with a negative length.");
+        }
+        if (newLength < itemCount) {
+            releaseItems(newLength, itemCount);
+        } else {
+            ensureCapacity(newLength);
+            std::fill(items.get() + itemCount, items.get() + newLength, T{});
+        }
+        itemCount = newLength;
+    }
+
     bool insert(int newPosition, const T &newEntry) {
         bool ableToInsert = (newPosition >= 1) &&
-                            (newPosition <= itemCount + 1) &&
-                            (itemCount < maxItems);
+                            (newPosition <= itemCount + 1);
         if (ableToInsert) {
+            // Copy first in case newEntry refers into this list and growing moves it.
+            T entry = newEntry;
+            ensureCapacity(itemCount + 1);
             // Make room for new entry by shifting all entries at
             // positions >= newPosition toward the end of the array
             // (no shift if newPosition == itemCount + 1)
-            for (int pos = itemCount; pos >= newPosition; pos--)
-                items[pos] = items[pos - 1];
+            shiftItems(newPosition - 1, newPosition);
             // Insert new entry
-            items[newPosition - 1] = newEntry;
+            items[newPosition - 1] = std::move(entry);
             itemCount++; // Increase count of entries
         } // end if
         return ableToInsert;
     }
 
+    // Inserts the entries [first, last) starting at newPosition, shifting the tail only once.
+    // The range may point into this list.
+    template<typename ForwardIterator>
+    bool insertRange(int newPosition, ForwardIterator first, ForwardIterator last) {
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition <= itemCount + 1);
+        if (ableToInsert) {
+            if (!pointsIntoItems(first, last)) {
+                copyIntoGap(newPosition, first, last);
+            } else {
+                // Growing would move the range and the shift would overwrite it, so copy it out.
+                std::vector<T> entries(first, last);
+                copyIntoGap(newPosition, std::make_move_iterator(entries.begin()),
+                            std::make_move_iterator(entries.end()));
+            }
+        } // end if
+        return ableToInsert;
+    }
+
     bool remove(int position) {
-        bool ableToRemove = (position >= 1) && (position <= itemCount);
+        return removeRange(position, 1);
+    };
+
+    // Removes count entries starting at position, shifting the tail only once.
+    bool removeRange(int position, int count) {
+        bool ableToRemove = (position >= 1) && (count >= 0) &&
+                            (count <= itemCount - position + 1);
         if (ableToRemove) {
-            // Remove entry by shifting all entries after the one at
-            // position toward the beginning of the array
-            // (no shift if position == itemCount)
-            for (int fromIndex = position, toIndex = fromIndex - 1;
-                 fromIndex < itemCount; fromIndex++, toIndex++)
-                items[toIndex] = items[fromIndex];
-            itemCount--; // Decrease count of entries
+            // Remove entries by shifting all entries after them
+            // toward the beginning of the array
+            // (no shift if they are the last ones)
+            shiftItems(position - 1 + count, position - 1);
+            releaseItems(itemCount - count, itemCount);
+            itemCount -= count; // Decrease count of entries
         } // end if
 
         return ableToRemove;
     };
 
     void clear() {
+        releaseItems(0, itemCount);
         itemCount = 0;
     };
 
@@ -134,58 +374,146 @@ TEST_CASE("testing array implementation of list adt") {
     testListADT(array0);
 }
 
+TEST_CASE("testing array list growth and range insert and remove") {
+    ArrayList<int, MAX_ARRAY_SIZE> list;
+    for (int i = 1; i <= 3 * MAX_ARRAY_SIZE; i++) {
+        CHECK(list.insert(i, i));
+    }
+    CHECK(list.getLength() == 3 * MAX_ARRAY_SIZE);
+    CHECK(list.getCapacity() >= 3 * MAX_ARRAY_SIZE);
+    CHECK(list.getEntry(1) == 1);
+    CHECK(list.getEntry(3 * MAX_ARRAY_SIZE) == 3 * MAX_ARRAY_SIZE);
+
+    int batch[] = {-1, -2, -3};
+    CHECK(list.insertRange(2, batch, batch + 3));
+    CHECK(list.getLength() == 3 * MAX_ARRAY_SIZE + 3);
+    CHECK(list.getEntry(1) == 1);
+    CHECK(list.getEntry(2) == -1);
+    CHECK(list.getEntry(4) == -3);
+    CHECK(list.getEntry(5) == 2);
+    CHECK_FALSE(list.insertRange(0, batch, batch + 3));
+
+    // A range from the list itself, while the insert both grows and shifts it.
+    ArrayList<int, MAX_ARRAY_SIZE> self;
+    for (int i = 1; i <= MAX_ARRAY_SIZE; i++) {
+        self.insert(i, i);
+    }
+    CHECK(self.insertRange(2, self.begin(), self.end()));
+    CHECK(self.getLength() == 2 * MAX_ARRAY_SIZE);
+    CHECK(self.getEntry(1) == 1);
+    for (int i = 1; i <= MAX_ARRAY_SIZE; i++) {
+        CHECK(self.getEntry(1 + i) == i);
+    }
+    CHECK(self.getEntry(MAX_ARRAY_SIZE + 2) == 2);
+    CHECK(self.getEntry(2 * MAX_ARRAY_SIZE) == MAX_ARRAY_SIZE);
+
+    // ... and one with room to spare, so only the shift could overwrite it.
+    self.reserve(4 * MAX_ARRAY_SIZE);
+    CHECK(self.insertRange(1, self.begin() + 1, self.begin() + 3));
+    CHECK(self.getEntry(1) == 1);
+    CHECK(self.getEntry(2) == 2);
+    CHECK(self.getEntry(3) == 1);
+    CHECK(self.getEntry(4) == 1);
+
+    CHECK(list.removeRange(2, 3));
+    CHECK(list.getEntry(2) == 2);
+    CHECK(list.getLength() == 3 * MAX_ARRAY_SIZE);
+    CHECK_FALSE(list.removeRange(3 * MAX_ARRAY_SIZE, 2));
+    CHECK_FALSE(list.removeRange(2, std::numeric_limits<int>::max()));
+    CHECK(list.getLength() == 3 * MAX_ARRAY_SIZE);
+
+    ArrayList<int, MAX_ARRAY_SIZE> copy(list);
+    list.replace(1, 100);
+    CHECK(copy.getEntry(1) == 1);
+
+    ArrayList<string, MAX_ARRAY_SIZE> words;
+    CHECK(words.insert(1, "world"));
+    CHECK(words.insert(1, "hello"));
+    CHECK(words.getEntry(1) == "hello");
+    CHECK(words.remove(1));
+    CHECK(words.getEntry(1) == "world");
+}
+
 template<typename T>
 class Node {
 private:
     T value;
-    std::shared_ptr<Node<T>> next;
+    std::unique_ptr<Node<T>> next; // each node owns the rest of the chain
     //Node *next;
 
 public:
     Node(T value) : value(value), next(nullptr) {}
 
-    Node(T value, std::shared_ptr<Node<T>> next) : value(value), next(next) {}
+    Node(T value, std::unique_ptr<Node<T>> next) : value(value), next(std::move(next)) {}
 
     T getItem() const {
         return value;
     }
 
-    auto getNext() const {
-        return next;
+    // Walking the chain only borrows the next node, so no ownership changes hands.
+    Node<T> *getNext() const {
+        return next.get();
     }
    /* Node *getNext() const {
         return next;
     } */
 
-    void setNext (std::shared_ptr<Node<T>> nextNodeptr){
-        next = nextNodeptr;
+    void setNext (std::unique_ptr<Node<T>> nextNodeptr){
+        next = std::move(nextNodeptr);
     }    
    /* void setNext(Node *n) {
         next = n;
     } */
 
+    // Hands the rest of the chain to the caller and leaves this node without a next.
+    std::unique_ptr<Node<T>> releaseNext() {
+        return std::move(next);
+    }
+
     void setItem(const T &v) {
         value = v;
     }
+
+    // Direct access to the stored value, used by the list's iterators.
+    T &getItemReference() {
+        return value;
+    }
+
+    const T &getItemReference() const {
+        return value;
+    }
 };
 
 template<class ItemType>
 class LinkedList : public ListADT<ItemType> {
 private :
     // Pointer to first node in the chain (contains the first entry in the list)
-    std::shared_ptr<Node<ItemType>> headPtr; // converted to a shared pointer
+    std::unique_ptr<Node<ItemType>> headPtr; // the list owns the head, each node owns its next
 
     // Current count of list items
     int itemCount;
 
-    std::shared_ptr<Node<ItemType>> getNodeAt(int position) const {
+    // Links a new node after tailPtr, or as the head when tailPtr is nullptr, and returns it.
+    Node<ItemType> *appendAfter(Node<ItemType> *tailPtr, const ItemType &newEntry) {
+        auto newNodePtr = std::make_unique<Node<ItemType>>(newEntry);
+        Node<ItemType> *newTailPtr = newNodePtr.get();
+        if (tailPtr == nullptr) {
+            headPtr = std::move(newNodePtr);
+        } else {
+            tailPtr->setNext(std::move(newNodePtr));
+        }
+        itemCount++;
+        return newTailPtr;
+    }
+
+    Node<ItemType> *getNodeAt(int position) const {
         // Debugging check of precondition
         if (position < 1 || position > itemCount) {
             throw std::out_of_range("Position out of range.");
         }
 
         // Count from the beginning of the chain
-        std::shared_ptr<Node<ItemType>> curPtr = headPtr;
+        Node<ItemType> *curPtr = headPtr.get();
         for (int skip = 1; skip < position; skip++)
             curPtr = curPtr->getNext();
         return curPtr;
@@ -194,10 +522,273 @@ private :
 public :
     LinkedList() : headPtr(nullptr), itemCount(0) {}
 
+    // Builds the list from [first, last) in one pass, appending at a remembered tail.
+    template<class InputIterator, class = typename std::iterator_traits<InputIterator>::iterator_category>
+    LinkedList(InputIterator first, InputIterator last) : headPtr(nullptr), itemCount(0) {
+        Node<ItemType> *tailPtr = nullptr;
+        for (; first != last; ++first) {
+            tailPtr = appendAfter(tailPtr, *first);
+        }
+    }
+
+    LinkedList(const LinkedList &other) : LinkedList(other.begin(), other.end()) {}
+
+    LinkedList(LinkedList &&other) noexcept : headPtr(std::move(other.headPtr)), itemCount(other.itemCount) {
+        other.itemCount = 0;
+    }
+
+    // Builds a list of n entries where entry i (counting from 0) is generate(i).
+    template<class Generator>
+    static LinkedList fromGenerator(int n, Generator generate) {
+        LinkedList list;
+        Node<ItemType> *tailPtr = nullptr;
+        for (int i = 0; i < n; i++) {
+            tailPtr = list.appendAfter(tailPtr, generate(i));
+        }
+        return list;
+    }
+
+    LinkedList &operator=(LinkedList other) {
+        std::swap(headPtr, other.headPtr);
+        std::swap(itemCount, other.itemCount);
+        return *this;
+    }
+
     ~LinkedList() {
         clear();
     };
 
+    // Forward iterator over the chain, so full scans are one walk instead of a getEntry per position.
+    template<bool IsConst>
+    class NodeIterator {
+    private:
+        using NodePointer = std::conditional_t<IsConst, const Node<ItemType> *, Node<ItemType> *>;
+        NodePointer curPtr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ItemType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const ItemType *, ItemType *>;
+        using reference = std::conditional_t<IsConst, const ItemType &, ItemType &>;
+
+        NodeIterator() : curPtr(nullptr) {}
+        explicit NodeIterator(NodePointer curPtr) : curPtr(curPtr) {}
+
+        reference operator*() const {
+            return curPtr->getItemReference();
+        }
+
+        pointer operator->() const {
+            return &curPtr->getItemReference();
+        }
+
+        NodeIterator &operator++() {
+            curPtr = curPtr->getNext();
+            return *this;
+        }
+
+        NodeIterator operator++(int) {
+            NodeIterator before = *this;
+            curPtr = curPtr->getNext();
+            return before;
+        }
+
+        bool operator==(const NodeIterator &other) const {
+            return curPtr == other.curPtr;
+        }
+
+        bool operator!=(const NodeIterator &other) const {
+            return curPtr != other.curPtr;
+        }
+    };
+
+    using iterator = NodeIterator<false>;
+    using const_iterator = NodeIterator<true>;
+
+    iterator begin() {
+        return iterator(headPtr.get());
+    }
+
+    iterator end() {
+        return iterator();
+    }
+
+    const_iterator begin() const {
+        return const_iterator(headPtr.get());
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    // A position in the list that edits happen at, remembering the node before it so inserting
+    // and removing there are O(1). insert puts an entry before the cursor's entry and remove takes
+    // the cursor's entry out, leaving the cursor on the entry that followed.
+    class Cursor {
+    private:
+        LinkedList *list;
+        Node<ItemType> *prevPtr; // nullptr while the cursor is on the first position
+        int position;
+
+        Node<ItemType> *currentNode() const {
+            return prevPtr != nullptr ? prevPtr->getNext() : list->headPtr.get();
+        }
+
+    public:
+        Cursor(LinkedList &list, Node<ItemType> *prevPtr, int position) : list(&list), prevPtr(prevPtr), position(position) {}
+
+        bool hasEntry() const {
+            return currentNode() != nullptr;
+        }
+
+        int getPosition() const {
+            return position;
+        }
+
+        ItemType getEntry() const {
+            if (!hasEntry()) {
+                throw std::out_of_range("Cursor is past the end of the list.");
+            }
+            return currentNode()->getItem();
+        }
+
+        void replace(const ItemType &newEntry) {
+            if (!hasEntry()) {
+                throw std::out_of_range("Cursor is past the end of the list.");
+            }
+            currentNode()->setItem(newEntry);
+        }
+
+        void advance() {
+            if (hasEntry()) {
+                prevPtr = currentNode();
+                position++;
+            }
+        }
+
+        void insert(const ItemType &newEntry) {
+            auto newNodePtr = std::make_unique<Node<ItemType>>(newEntry);
+            Node<ItemType> *insertedPtr = newNodePtr.get();
+            if (prevPtr == nullptr) {
+                newNodePtr->setNext(std::move(list->headPtr));
+                list->headPtr = std::move(newNodePtr);
+            } else {
+                newNodePtr->setNext(prevPtr->releaseNext());
+                prevPtr->setNext(std::move(newNodePtr));
+            }
+            prevPtr = insertedPtr;
+            position++;
+            list->itemCount++;
+        }
+
+        bool remove() {
+            if (!hasEntry()) {
+                return false;
+            }
+            if (prevPtr == nullptr) {
+                list->headPtr = list->headPtr->releaseNext();
+            } else {
+                std::unique_ptr<Node<ItemType>> curPtr = prevPtr->releaseNext();
+                prevPtr->setNext(curPtr->releaseNext());
+            }
+            list->itemCount--;
+            return true;
+        }
+    };
+
+    // Returns a cursor on the given position, which may be one past the last entry.
+    Cursor cursor(int position = 1) {
+        if (position < 1 || position > itemCount + 1) {
+            throw std::out_of_range("Position out of range.");
+        }
+        return Cursor(*this, position > 1 ? getNodeAt(position - 1) : nullptr, position);
+    }
+
+    // Sorts the chain in place by relinking nodes, never copying entries. This is a bottom-up
+    // natural merge sort: each pass merges neighbouring ascending runs, so already sorted input
+    // takes a single O(n) pass and the worst case is O(n log n). Equal entries keep their order.
+    template<class Compare = std::less<>>
+    void sort(Compare comp = Compare()) {
+        if (headPtr == nullptr) {
+            return;
+        }
+
+        while (true) {
+            std::unique_ptr<Node<ItemType>> remaining = std::move(headPtr);
+            Node<ItemType> *tailPtr = nullptr;
+            int mergeCount = 0;
+            while (remaining != nullptr) {
+                std::unique_ptr<Node<ItemType>> left = std::move(remaining);
+                std::unique_ptr<Node<ItemType>> right = splitAfterRun(left.get(), comp);
+                remaining = right != nullptr ? splitAfterRun(right.get(), comp) : nullptr;
+
+                Node<ItemType> *mergedTailPtr;
+                std::unique_ptr<Node<ItemType>> merged = mergeRuns(std::move(left), std::move(right), comp, mergedTailPtr);
+                if (tailPtr == nullptr) {
+                    headPtr = std::move(merged);
+                } else {
+                    tailPtr->setNext(std::move(merged));
+                }
+                tailPtr = mergedTailPtr;
+                mergeCount++;
+            }
+            if (mergeCount == 1) {
+                return;
+            }
+        }
+    }
+
+private :
+    // Cuts the chain after the ascending run starting at runPtr and returns the rest.
+    template<class Compare>
+    static std::unique_ptr<Node<ItemType>> splitAfterRun(Node<ItemType> *runPtr, Compare &comp) {
+        while (runPtr->getNext() != nullptr &&
+               !comp(runPtr->getNext()->getItemReference(), runPtr->getItemReference())) {
+            runPtr = runPtr->getNext();
+        }
+        return runPtr->releaseNext();
+    }
+
+    // Merges two sorted chains, taking from left on ties, and reports the last node of the result.
+    template<class Compare>
+    static std::unique_ptr<Node<ItemType>> mergeRuns(std::unique_ptr<Node<ItemType>> left,
+                                                     std::unique_ptr<Node<ItemType>> right,
+                                                     Compare &comp, Node<ItemType> *&tailPtr) {
+        std::unique_ptr<Node<ItemType>> merged;
+        tailPtr = nullptr;
+        while (left != nullptr && right != nullptr) {
+            std::unique_ptr<Node<ItemType>> &source =
+                    comp(right->getItemReference(), left->getItemReference()) ? right : left;
+            std::unique_ptr<Node<ItemType>> nodePtr = std::move(source);
+            source = nodePtr->releaseNext();
+            Node<ItemType> *newTailPtr = nodePtr.get();
+            if (tailPtr == nullptr) {
+                merged = std::move(nodePtr);
+            } else {
+                tailPtr->setNext(std::move(nodePtr));
+            }
+            tailPtr = newTailPtr;
+        }
+
+        std::unique_ptr<Node<ItemType>> &rest = left != nullptr ? left : right;
+        if (rest != nullptr) {
+            Node<ItemType> *restTailPtr = rest.get();
+            while (restTailPtr->getNext() != nullptr) {
+                restTailPtr = restTailPtr->getNext();
+            }
+            if (tailPtr == nullptr) {
+                merged = std::move(rest);
+            } else {
+                tailPtr->setNext(std::move(rest));
+            }
+            tailPtr = restTailPtr;
+        }
+        return merged;
+    }
+
+public :
+
     bool isEmpty() const {
         return itemCount == 0;
     }
@@ -211,18 +802,18 @@ public :
                             (newPosition <= itemCount + 1);
         if (ableToInsert) {
             // Create a new node containing the new entry
-            std::shared_ptr<Node<ItemType>> newNodePtr = std::make_shared<Node<ItemType>>(newEntry);
+            auto newNodePtr = std::make_unique<Node<ItemType>>(newEntry);
             // Attach new node to chain
             if (newPosition == 1) {
                 // Insert new node at beginning of chain
-                newNodePtr->setNext(headPtr);
-                headPtr = newNodePtr;
+                newNodePtr->setNext(std::move(headPtr));
+                headPtr = std::move(newNodePtr);
             } else {
                 // Find node that will be before new node
-                std::shared_ptr<Node<ItemType>> prevPtr = getNodeAt(newPosition - 1);
+                Node<ItemType> *prevPtr = getNodeAt(newPosition - 1);
                 // Insert new node after node to which prevPtr points
-                newNodePtr->setNext(prevPtr->getNext());
-                prevPtr->setNext(newNodePtr);
+                newNodePtr->setNext(prevPtr->releaseNext());
+                prevPtr->setNext(std::move(newNodePtr));
             } // end if
             itemCount++; // Increase count of entries
         } // end if
@@ -232,39 +823,36 @@ public :
     bool remove(int position) {
         bool ableToRemove = (position >= 1) && (position <= itemCount);
         if (ableToRemove) {
-            std::shared_ptr<Node<ItemType>> curPtr = nullptr;
             if (position == 1) {
-                // Remove the first node in the chain
-                curPtr = headPtr; // Save pointer to node
-                headPtr = headPtr->getNext();
+                // Remove the first node in the chain. The old head is freed
+                // once nothing owns it.
+                headPtr = headPtr->releaseNext();
             } else {
                 // Find node that is before the one to delete
-                std::shared_ptr<Node<ItemType>> prevPtr = getNodeAt(position - 1);
-                // Point to node to delete
-                curPtr = prevPtr->getNext();
-                // Disconnect indicated node from chain by connecting the
+                Node<ItemType> *prevPtr = getNodeAt(position - 1);
+                // Take the node to delete out of the chain and connect the
                 // prior node with the one after
-                prevPtr->setNext(curPtr->getNext());
+                std::unique_ptr<Node<ItemType>> curPtr = prevPtr->releaseNext();
+                prevPtr->setNext(curPtr->releaseNext());
             } // end if
-            // Return node to system
-            //curPtr->setNext(nullptr);
-            //delete curPtr;
-            //curPtr = nullptr;
             itemCount--; // Decrease count of entries
         } // end if
         return ableToRemove;
     }
 
+    // Frees the chain one node at a time. Letting headPtr go would free it
+    // recursively, one stack frame per node.
     void clear() {
-        while (!isEmpty())
-            remove(1);
+        while (headPtr != nullptr)
+            headPtr = headPtr->releaseNext();
+        itemCount = 0;
     }
 
     ItemType getEntry(int position) const {
         // Enforce precondition
         bool ableToGet = (position >= 1) && (position <= itemCount);
         if (ableToGet) {
-            std::shared_ptr<Node<ItemType>> nodePtr = getNodeAt(position);
+            Node<ItemType> *nodePtr = getNodeAt(position);
             return nodePtr->getItem();
         } else {
             string message = "getEntry() called with an empty list or ";
@@ -274,7 +862,7 @@ public :
     }
 
     void replace(int position, const ItemType &newEntry) {
-        std::shared_ptr<Node<ItemType>> n = getNodeAt(position);
+        Node<ItemType> *n = getNodeAt(position);
         n->setItem(newEntry);
     }
 }; // end LinkedList
@@ -283,110 +871,3402 @@ TEST_CASE("test linked chain implementation of list adt") {
     LinkedList<int> list0;
 
     testListADT(list0);
+
+    LinkedList<int> list1;
+    for (int i = 1; i <= 100000; i++) {
+        list1.insert(1, i);
+    }
+    LinkedList<int> list2(list1);
+    list1.clear();
+    CHECK(list1.isEmpty());
+    CHECK(list2.getLength() == 100000);
+    CHECK(list2.getEntry(1) == 100000);
+    CHECK(list2.getEntry(100000) == 1);
 }
 
-// ***** PART 2 *****
+// ***** GAP BUFFER LIST *****
 
-template<typename ItemType>
-void insertionSort(ListADT<ItemType> & list) {
-    for (int i = 2; i<=list.getLength(); i++){ // for loop starts at 2 because the first item in the array is already "sorted"
-        ItemType tempVariable = list.getEntry(i);
-        int j = 1; 
-        while (tempVariable > list.getEntry(j)){
-            j++;
-        }
-        list.remove(i);
-        list.insert(j, tempVariable);
-    }
+// A list kept in one array with a gap of free slots at the last edit point. Inserting or removing
+// next to the gap only touches the gap's edge, and moving the gap costs the distance moved, so edits
+// clustered around a cursor are O(1) amortized while getEntry stays O(1).
+template<typename T>
+class GapBufferList final : public ListADT<T> {
+private:
+    static constexpr int MIN_CAPACITY = 16;
 
-}
+    std::vector<T> buffer; // entries before the gap, the gap, then entries after it
+    int gapStart;          // index of the first free slot, also the number of entries before the gap
+    int gapEnd;            // index one past the last free slot
 
-void fillRandom(ListADT<int> & list, int n) {
-    for(int i=0; i<n; ++i) {
-        int j = std::rand();
-        list.insert(1, j);
+    int gapSize() const {
+        return gapEnd - gapStart;
     }
-}
 
-bool isSorted(const ListADT<int> & list) {
-    int n = list.getLength();
-    if(n <= 1) {
-        return true;
+    // Index into buffer of the entry at the given zero based index.
+    int bufferIndex(int index) const {
+        return index < gapStart ? index : index + gapSize();
     }
 
-    for(int i=1; i<n; ++i) {
-        if(list.getEntry(i) > list.getEntry(i+1)) {
-            return false;
+    // Moves the gap so that it sits just before the entry at the given zero based index.
+    void moveGapTo(int index) {
+        if (index < gapStart) {
+            int count = gapStart - index;
+            std::move_backward(buffer.begin() + index, buffer.begin() + gapStart, buffer.begin() + gapEnd);
+            gapStart -= count;
+            gapEnd -= count;
+        } else if (index > gapStart) {
+            int count = index - gapStart;
+            std::move(buffer.begin() + gapEnd, buffer.begin() + gapEnd + count, buffer.begin() + gapStart);
+            gapStart += count;
+            gapEnd += count;
         }
     }
 
-    return true;
-}
+    // Doubles the buffer, keeping the gap where it is.
+    void growGap() {
+        int oldCapacity = static_cast<int>(buffer.size());
+        int newCapacity = std::max(MIN_CAPACITY, oldCapacity * 2);
+        std::vector<T> newBuffer(newCapacity);
+        std::move(buffer.begin(), buffer.begin() + gapStart, newBuffer.begin());
+        int tailCount = oldCapacity - gapEnd;
+        std::move(buffer.begin() + gapEnd, buffer.end(), newBuffer.end() - tailCount);
+        buffer.swap(newBuffer);
+        gapEnd = newCapacity - tailCount;
+    }
 
-TEST_CASE("testing linked chain insertion sort") {
-    LinkedList<int> list0;
-    insertionSort(list0);
-    CHECK(list0.isEmpty());
+public:
+    GapBufferList() : buffer(MIN_CAPACITY), gapStart(0), gapEnd(MIN_CAPACITY) {}
 
-    LinkedList<int> list1;
-    CHECK(list1.insert(1, 10));
-    insertionSort(list1);
-    CHECK(list1.getLength() == 1);
+    bool isEmpty() const {
+        return getLength() == 0;
+    }
 
-    LinkedList<int> list2;
-    CHECK(list2.insert(1, 10));
-    CHECK(list2.insert(1, 20));
-    insertionSort(list2);
-    CHECK(list2.getEntry(1) == 10);
-    CHECK(list2.getEntry(2) == 20);
+    int getLength() const {
+        return static_cast<int>(buffer.size()) - gapSize();
+    }
 
-    LinkedList<int> list3;
-    CHECK(list3.insert(1, 10));
-    CHECK(list3.insert(1, 20));
-    CHECK(list3.insert(1, 30));
+    bool insert(int newPosition, const T &newEntry) {
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition <= getLength() + 1);
+        if (ableToInsert) {
+            T entry = newEntry;
+            moveGapTo(newPosition - 1);
+            if (gapSize() == 0) {
+                growGap();
+            }
+            buffer[gapStart++] = std::move(entry);
+        } // end if
+        return ableToInsert;
+    }
 
-    insertionSort(list3);
+    bool remove(int position) {
+        bool ableToRemove = (position >= 1) && (position <= getLength());
+        if (ableToRemove) {
+            // Move the gap up to the entry and let the gap swallow it.
+            moveGapTo(position - 1);
+            buffer[gapEnd++] = T{};
+        } // end if
+        return ableToRemove;
+    }
+
+    void clear() {
+        buffer.assign(MIN_CAPACITY, T{});
+        gapStart = 0;
+        gapEnd = MIN_CAPACITY;
+    }
+
+    T getEntry(int position) const {
+        // Enforce precondition
+        bool ableToGet = (position >= 1) && (position <= getLength());
+        if (ableToGet)
+            return buffer[bufferIndex(position - 1)];
+        else {
+            string message = "getEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        } // end if
+    }
+
+    void replace(int position, const T &newEntry) {
+        // Enforce precondition
+        bool ableToSet = (position >= 1) && (position <= getLength());
+        if (ableToSet)
+            buffer[bufferIndex(position - 1)] = newEntry;
+        else {
+            string message = "setEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        } // end if
+    }
+}; // end GapBufferList
+
+TEST_CASE("test gap buffer implementation of list adt") {
+    GapBufferList<int> list0;
+
+    testListADT(list0);
+
+    // Type at a cursor, jump back, delete and type again, like an editor would.
+    GapBufferList<char> text;
+    string typed = "hello world";
+    for (int i = 0; i < static_cast<int>(typed.size()); i++) {
+        CHECK(text.insert(i + 1, typed[i]));
+    }
+    CHECK(text.remove(6));
+    CHECK(text.insert(6, ','));
+    CHECK(text.insert(7, ' '));
+    CHECK(text.remove(1));
+    CHECK(text.insert(1, 'H'));
+    for (int i = 0; i < 40; i++) {
+        CHECK(text.insert(text.getLength() + 1, '!'));
+    }
+    CHECK_FALSE(text.insert(text.getLength() + 2, '?'));
+    CHECK_FALSE(text.remove(0));
+
+    string result;
+    for (int i = 1; i <= text.getLength(); i++) {
+        result += text.getEntry(i);
+    }
+    CHECK(result == "Hello, world" + string(40, '!'));
+}
+
+// ***** UNROLLED LINKED LIST *****
+
+// A linked list whose nodes each hold a small array of entries sized to about one cache line, so
+// walks, inserts and removes touch one node per chunk of entries instead of one per entry.
+template<typename T>
+class UnrolledLinkedList final : public ListADT<T> {
+private:
+    static constexpr int CACHE_LINE_BYTES = 64;
+    static constexpr int CHUNK_CAPACITY = sizeof(T) * 4 > CACHE_LINE_BYTES ? 4 : CACHE_LINE_BYTES / sizeof(T);
+
+    struct Chunk {
+        T items[CHUNK_CAPACITY]{};
+        int count = 0;
+        Chunk *next = nullptr;
+    };
+
+    Chunk *headPtr;
+    Chunk *tailPtr;
+    int itemCount;
+
+    // Finds the chunk holding the entry at the given zero based index and turns index into the
+    // offset within that chunk. Also reports the chunk before it, or nullptr for the first one.
+    Chunk *findChunk(int &index, Chunk *&prevPtr) const {
+        prevPtr = nullptr;
+        Chunk *curPtr = headPtr;
+        while (index >= curPtr->count) {
+            index -= curPtr->count;
+            prevPtr = curPtr;
+            curPtr = curPtr->next;
+        }
+        return curPtr;
+    }
+
+    // Links a new empty chunk after the given one.
+    Chunk *addChunkAfter(Chunk *chunk) {
+        Chunk *newChunk = new Chunk;
+        newChunk->next = chunk->next;
+        chunk->next = newChunk;
+        if (tailPtr == chunk) {
+            tailPtr = newChunk;
+        }
+        return newChunk;
+    }
+
+public:
+    UnrolledLinkedList() : headPtr(nullptr), tailPtr(nullptr), itemCount(0) {}
+
+    UnrolledLinkedList(const UnrolledLinkedList &other) : UnrolledLinkedList() {
+        for (Chunk *chunk = other.headPtr; chunk != nullptr; chunk = chunk->next) {
+            Chunk *copy = new Chunk(*chunk);
+            copy->next = nullptr;
+            if (tailPtr == nullptr) {
+                headPtr = copy;
+            } else {
+                tailPtr->next = copy;
+            }
+            tailPtr = copy;
+        }
+        itemCount = other.itemCount;
+    }
+
+    UnrolledLinkedList &operator=(UnrolledLinkedList other) {
+        std::swap(headPtr, other.headPtr);
+        std::swap(tailPtr, other.tailPtr);
+        std::swap(itemCount, other.itemCount);
+        return *this;
+    }
+
+    ~UnrolledLinkedList() {
+        clear();
+    }
+
+    bool isEmpty() const {
+        return itemCount == 0;
+    }
+
+    int getLength() const {
+        return itemCount;
+    }
+
+    bool insert(int newPosition, const T &newEntry) {
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition <= itemCount + 1);
+        if (ableToInsert) {
+            T entry = newEntry;
+            Chunk *chunk;
+            int offset;
+            if (headPtr == nullptr) {
+                headPtr = tailPtr = new Chunk;
+                chunk = headPtr;
+                offset = 0;
+            } else if (newPosition == itemCount + 1) {
+                // Appending goes straight to the last chunk.
+                chunk = tailPtr;
+                offset = chunk->count;
+            } else {
+                Chunk *prevPtr;
+                offset = newPosition - 1;
+                chunk = findChunk(offset, prevPtr);
+            }
+
+            if (chunk->count == CHUNK_CAPACITY) {
+                if (offset == CHUNK_CAPACITY) {
+                    // Adding past the end of a full chunk starts a fresh one.
+                    chunk = addChunkAfter(chunk);
+                    offset = 0;
+                } else {
+                    // Split the full chunk in half and insert into whichever half owns offset.
+                    Chunk *upper = addChunkAfter(chunk);
+                    int half = CHUNK_CAPACITY / 2;
+                    std::move(chunk->items + half, chunk->items + CHUNK_CAPACITY, upper->items);
+                    upper->count = CHUNK_CAPACITY - half;
+                    chunk->count = half;
+                    if (offset > half) {
+                        chunk = upper;
+                        offset -= half;
+                    }
+                }
+            }
+
+            std::move_backward(chunk->items + offset, chunk->items + chunk->count, chunk->items + chunk->count + 1);
+            chunk->items[offset] = std::move(entry);
+            chunk->count++;
+            itemCount++; // Increase count of entries
+        } // end if
+        return ableToInsert;
+    }
+
+    bool remove(int position) {
+        bool ableToRemove = (position >= 1) && (position <= itemCount);
+        if (ableToRemove) {
+            Chunk *prevPtr;
+            int offset = position - 1;
+            Chunk *chunk = findChunk(offset, prevPtr);
+            std::move(chunk->items + offset + 1, chunk->items + chunk->count, chunk->items + offset);
+            chunk->count--;
+            chunk->items[chunk->count] = T{};
+            itemCount--; // Decrease count of entries
+
+            if (chunk->count == 0) {
+                // Unlink the empty chunk
+                if (prevPtr == nullptr) {
+                    headPtr = chunk->next;
+                } else {
+                    prevPtr->next = chunk->next;
+                }
+                if (tailPtr == chunk) {
+                    tailPtr = prevPtr;
+                }
+                delete chunk;
+            } else if (chunk->next != nullptr && chunk->count + chunk->next->count <= CHUNK_CAPACITY) {
+                // Merge with the next chunk while both fit, which keeps chunks at least half full on average.
+                Chunk *next = chunk->next;
+                std::move(next->items, next->items + next->count, chunk->items + chunk->count);
+                chunk->count += next->count;
+                chunk->next = next->next;
+                if (tailPtr == next) {
+                    tailPtr = chunk;
+                }
+                delete next;
+            } // end if
+        } // end if
+        return ableToRemove;
+    }
+
+    void clear() {
+        while (headPtr != nullptr) {
+            Chunk *next = headPtr->next;
+            delete headPtr;
+            headPtr = next;
+        }
+        tailPtr = nullptr;
+        itemCount = 0;
+    }
+
+    T getEntry(int position) const {
+        // Enforce precondition
+        bool ableToGet = (position >= 1) && (position <= itemCount);
+        if (ableToGet) {
+            Chunk *prevPtr;
+            int offset = position - 1;
+            return findChunk(offset, prevPtr)->items[offset];
+        } else {
+            string message = "getEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    void replace(int position, const T &newEntry) {
+        // Enforce precondition
+        bool ableToSet = (position >= 1) && (position <= itemCount);
+        if (ableToSet) {
+            Chunk *prevPtr;
+            int offset = position - 1;
+            findChunk(offset, prevPtr)->items[offset] = newEntry;
+        } else {
+            string message = "setEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+}; // end UnrolledLinkedList
+
+TEST_CASE("test unrolled linked list implementation of list adt") {
+    UnrolledLinkedList<int> list0;
+
+    testListADT(list0);
+
+    // Mix inserts and removes at random positions and compare against a vector.
+    std::srand(30);
+    UnrolledLinkedList<int> list1;
+    std::vector<int> expected;
+    for (int i = 0; i < 2000; i++) {
+        if (expected.empty() || std::rand() % 3 != 0) {
+            int position = std::rand() % (static_cast<int>(expected.size()) + 1) + 1;
+            CHECK(list1.insert(position, i));
+            expected.insert(expected.begin() + position - 1, i);
+        } else {
+            int position = std::rand() % static_cast<int>(expected.size()) + 1;
+            CHECK(list1.remove(position));
+            expected.erase(expected.begin() + position - 1);
+        }
+    }
+    REQUIRE(list1.getLength() == static_cast<int>(expected.size()));
+    bool allMatch = true;
+    for (int i = 0; i < list1.getLength(); i++) {
+        allMatch = allMatch && list1.getEntry(i + 1) == expected[i];
+    }
+    CHECK(allMatch);
+
+    UnrolledLinkedList<int> list2(list1);
+    list1.clear();
+    CHECK(list1.isEmpty());
+    CHECK(list2.getLength() == static_cast<int>(expected.size()));
+    CHECK(list1.insert(1, 7));
+    CHECK(list1.getEntry(1) == 7);
+}
+
+// ***** INDEXABLE SKIP LIST *****
+
+// A skip list where every forward link also records how many entries it jumps over. Finding a
+// position follows the widest links that don't overshoot, so getEntry, insert, remove and replace
+// are all O(log n) expected instead of walking the chain from the head.
+template<typename T>
+class IndexableSkipList final : public ListADT<T> {
+private:
+    static constexpr int MAX_LEVEL = 32;
+
+    struct SkipNode {
+        T item;
+        std::vector<SkipNode *> next; // one forward link per level
+        std::vector<int> width;       // entries each link moves forward by
+
+        SkipNode(const T &item, int levels) : item(item), next(levels, nullptr), width(levels, 0) {}
+    };
+
+    SkipNode *headPtr; // sentinel with MAX_LEVEL links
+    int levelCount;    // levels in use
+    int itemCount;
+    std::mt19937 levelGenerator;
+
+    // Each level above the first is kept with probability 1/2.
+    int randomLevels() {
+        int levels = 1;
+        while (levels < MAX_LEVEL && (levelGenerator() & 1) != 0) {
+            levels++;
+        }
+        return levels;
+    }
+
+    // Returns the node at the given position, with the sentinel at position 0.
+    SkipNode *getNodeAt(int position) const {
+        SkipNode *curPtr = headPtr;
+        int reached = 0;
+        for (int level = levelCount - 1; level >= 0; level--) {
+            while (curPtr->next[level] != nullptr && reached + curPtr->width[level] <= position) {
+                reached += curPtr->width[level];
+                curPtr = curPtr->next[level];
+            }
+        }
+        return curPtr;
+    }
+
+    // Fills in, for every level, the last node before the given position and that node's position.
+    void findPredecessors(int position, SkipNode *update[], int reached[]) const {
+        SkipNode *curPtr = headPtr;
+        int curPosition = 0;
+        for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+            while (curPtr->next[level] != nullptr && curPosition + curPtr->width[level] < position) {
+                curPosition += curPtr->width[level];
+                curPtr = curPtr->next[level];
+            }
+            update[level] = curPtr;
+            reached[level] = curPosition;
+        }
+    }
+
+public:
+    IndexableSkipList() : headPtr(new SkipNode(T{}, MAX_LEVEL)), levelCount(1), itemCount(0), levelGenerator(5489u) {}
+
+    IndexableSkipList(const IndexableSkipList &other) : IndexableSkipList() {
+        for (int position = 1; position <= other.itemCount; position++) {
+            insert(position, other.getEntry(position));
+        }
+    }
+
+    IndexableSkipList &operator=(IndexableSkipList other) {
+        std::swap(headPtr, other.headPtr);
+        std::swap(levelCount, other.levelCount);
+        std::swap(itemCount, other.itemCount);
+        return *this;
+    }
+
+    ~IndexableSkipList() {
+        clear();
+        delete headPtr;
+    }
+
+    bool isEmpty() const {
+        return itemCount == 0;
+    }
+
+    int getLength() const {
+        return itemCount;
+    }
+
+    bool insert(int newPosition, const T &newEntry) {
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition <= itemCount + 1);
+        if (ableToInsert) {
+            SkipNode *update[MAX_LEVEL];
+            int reached[MAX_LEVEL];
+            findPredecessors(newPosition, update, reached);
+
+            int levels = randomLevels();
+            levelCount = std::max(levelCount, levels);
+            SkipNode *newNodePtr = new SkipNode(newEntry, levels);
+            for (int level = 0; level < MAX_LEVEL; level++) {
+                SkipNode *prevPtr = update[level];
+                if (level < levels) {
+                    // Split prevPtr's link around the new node. Links from the sentinel past the
+                    // last node have width 0 and nothing to split.
+                    int before = newPosition - reached[level];
+                    newNodePtr->next[level] = prevPtr->next[level];
+                    newNodePtr->width[level] = prevPtr->next[level] != nullptr ? prevPtr->width[level] - before + 1 : 0;
+                    prevPtr->next[level] = newNodePtr;
+                    prevPtr->width[level] = before;
+                } else if (prevPtr->next[level] != nullptr) {
+                    // Higher links now jump over one more entry.
+                    prevPtr->width[level]++;
+                }
+            }
+            itemCount++; // Increase count of entries
+        } // end if
+        return ableToInsert;
+    }
+
+    bool remove(int position) {
+        bool ableToRemove = (position >= 1) && (position <= itemCount);
+        if (ableToRemove) {
+            SkipNode *update[MAX_LEVEL];
+            int reached[MAX_LEVEL];
+            findPredecessors(position, update, reached);
+
+            SkipNode *curPtr = update[0]->next[0];
+            for (int level = 0; level < MAX_LEVEL; level++) {
+                SkipNode *prevPtr = update[level];
+                if (prevPtr->next[level] == curPtr) {
+                    prevPtr->next[level] = curPtr->next[level];
+                    prevPtr->width[level] = curPtr->next[level] != nullptr ? prevPtr->width[level] + curPtr->width[level] - 1 : 0;
+                } else if (prevPtr->next[level] != nullptr) {
+                    prevPtr->width[level]--;
+                }
+            }
+            delete curPtr;
+            while (levelCount > 1 && headPtr->next[levelCount - 1] == nullptr) {
+                levelCount--;
+            }
+            itemCount--; // Decrease count of entries
+        } // end if
+        return ableToRemove;
+    }
+
+    void clear() {
+        SkipNode *curPtr = headPtr->next[0];
+        while (curPtr != nullptr) {
+            SkipNode *next = curPtr->next[0];
+            delete curPtr;
+            curPtr = next;
+        }
+        std::fill(headPtr->next.begin(), headPtr->next.end(), nullptr);
+        std::fill(headPtr->width.begin(), headPtr->width.end(), 0);
+        levelCount = 1;
+        itemCount = 0;
+    }
+
+    T getEntry(int position) const {
+        // Enforce precondition
+        bool ableToGet = (position >= 1) && (position <= itemCount);
+        if (ableToGet) {
+            return getNodeAt(position)->item;
+        } else {
+            string message = "getEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    void replace(int position, const T &newEntry) {
+        // Enforce precondition
+        bool ableToSet = (position >= 1) && (position <= itemCount);
+        if (ableToSet) {
+            getNodeAt(position)->item = newEntry;
+        } else {
+            string message = "setEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+}; // end IndexableSkipList
+
+TEST_CASE("test indexable skip list implementation of list adt") {
+    IndexableSkipList<int> list0;
+
+    testListADT(list0);
+
+    std::srand(31);
+    IndexableSkipList<int> list1;
+    std::vector<int> expected;
+    for (int i = 0; i < 2000; i++) {
+        if (expected.empty() || std::rand() % 3 != 0) {
+            int position = std::rand() % (static_cast<int>(expected.size()) + 1) + 1;
+            CHECK(list1.insert(position, i));
+            expected.insert(expected.begin() + position - 1, i);
+        } else {
+            int position = std::rand() % static_cast<int>(expected.size()) + 1;
+            CHECK(list1.remove(position));
+            expected.erase(expected.begin() + position - 1);
+        }
+    }
+    REQUIRE(list1.getLength() == static_cast<int>(expected.size()));
+    bool allMatch = true;
+    for (int i = 0; i < list1.getLength(); i++) {
+        allMatch = allMatch && list1.getEntry(i + 1) == expected[i];
+    }
+    CHECK(allMatch);
+
+    list1.replace(list1.getLength(), -1);
+    CHECK(list1.getEntry(list1.getLength()) == -1);
+    IndexableSkipList<int> list2(list1);
+    CHECK(list2.getLength() == list1.getLength());
+    CHECK(list2.getEntry(list2.getLength()) == -1);
+}
+
+template<typename Work>
+double secondsToRun(Work work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Compares walking and clearing LinkedList with the chain it replaced, whose nodes linked with
+// std::shared_ptr: every step of a walk copied a shared_ptr, paying an atomic increment and
+// decrement, and clear removed the head one call at a time.
+// Skipped by default, run the executable with --no-skip to see the timings.
+TEST_CASE("benchmark linked list traversal and clear" * doctest::skip()) {
+    struct SharedNode {
+        int value;
+        std::shared_ptr<SharedNode> next;
+    };
+    std::shared_ptr<SharedNode> sharedHead;
+    auto sharedEntry = [&sharedHead](int position) {
+        std::shared_ptr<SharedNode> curPtr = sharedHead;
+        for (int skip = 1; skip < position; skip++)
+            curPtr = curPtr->next;
+        return curPtr->value;
+    };
+
+    const int walkLength = 4000;
+    const int clearLength = 1000000;
+
+    LinkedList<int> ownedList;
+    for (int i = 0; i < walkLength; i++) {
+        sharedHead = std::make_shared<SharedNode>(SharedNode{i, sharedHead});
+        ownedList.insert(1, i);
+    }
+
+    // getEntry walks from the head, so reading every position walks n^2 / 2 links.
+    long long sharedSum = 0;
+    long long ownedSum = 0;
+    double sharedWalk = secondsToRun([&]() {
+        for (int i = 1; i <= walkLength; i++) sharedSum += sharedEntry(i);
+    });
+    double ownedWalk = secondsToRun([&]() {
+        for (int i = 1; i <= walkLength; i++) ownedSum += ownedList.getEntry(i);
+    });
+    CHECK(sharedSum == ownedSum);
+    double links = static_cast<double>(walkLength) * walkLength / 2;
+    std::cout << "walk shared_ptr chain: " << links / sharedWalk << " links/sec" << std::endl;
+    std::cout << "walk unique_ptr chain: " << links / ownedWalk << " links/sec" << std::endl;
+
+    for (int i = 0; i < clearLength; i++) {
+        sharedHead = std::make_shared<SharedNode>(SharedNode{i, sharedHead});
+        ownedList.insert(1, i);
+    }
+    double sharedClear = secondsToRun([&]() {
+        while (sharedHead != nullptr) {
+            std::shared_ptr<SharedNode> removed = sharedHead;
+            sharedHead = removed->next;
+        }
+    });
+    double ownedClear = secondsToRun([&]() { ownedList.clear(); });
+    CHECK(ownedList.isEmpty());
+    std::cout << "clear shared_ptr chain: " << clearLength / sharedClear << " nodes/sec" << std::endl;
+    std::cout << "clear unique_ptr chain: " << clearLength / ownedClear << " nodes/sec" << std::endl;
+}
+
+// ***** PART 2 *****
+
+template<typename ItemType>
+void insertionSort(ListADT<ItemType> & list) {
+    for (int i = 2; i<=list.getLength(); i++){ // for loop starts at 2 because the first item in the array is already "sorted"
+        ItemType tempVariable = list.getEntry(i);
+        int j = 1; 
+        while (tempVariable > list.getEntry(j)){
+            j++;
+        }
+        list.remove(i);
+        list.insert(j, tempVariable);
+    }
+
+}
+
+void fillRandom(ListADT<int> & list, int n) {
+    for(int i=0; i<n; ++i) {
+        int j = std::rand();
+        list.insert(1, j);
+    }
+}
+
+bool isSorted(const ListADT<int> & list) {
+    int n = list.getLength();
+    if(n <= 1) {
+        return true;
+    }
+
+    for(int i=1; i<n; ++i) {
+        if(list.getEntry(i) > list.getEntry(i+1)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Lists with iterators are checked in one pass instead of a getEntry per position.
+template<typename ItemType, int N>
+bool isSorted(const ArrayList<ItemType, N> & list) {
+    return std::is_sorted(list.begin(), list.end());
+}
+
+template<typename ItemType>
+bool isSorted(const LinkedList<ItemType> & list) {
+    return std::is_sorted(list.begin(), list.end());
+}
+
+template<class ListType>
+void testIteratorsAndCursor(ListType& list) {
+    CHECK(list.begin() == list.end());
+    for (int i = 1; i <= 5; i++) {
+        CHECK(list.insert(i, i * 10));
+    }
+    CHECK(std::accumulate(list.begin(), list.end(), 0) == 150);
+    CHECK(std::find(list.begin(), list.end(), 30) != list.end());
+    CHECK(std::find(list.begin(), list.end(), 35) == list.end());
+    CHECK(isSorted(list));
+
+    for (auto& entry : list) {
+        entry += 1;
+    }
+    CHECK(list.getEntry(1) == 11);
+    CHECK(list.getEntry(5) == 51);
+
+    // Walk the list with a cursor, dropping 31 and putting 25 in front of 41.
+    auto cursor = list.cursor();
+    while (cursor.hasEntry()) {
+        if (cursor.getEntry() == 31) {
+            CHECK(cursor.remove());
+        } else {
+            if (cursor.getEntry() == 41) {
+                cursor.insert(25);
+            }
+            cursor.advance();
+        }
+    }
+    CHECK(cursor.getPosition() == 6);
+    CHECK_FALSE(cursor.remove());
+    cursor.insert(99);
+    CHECK(list.getLength() == 6);
+
+    int expected[] = {11, 21, 25, 41, 51, 99};
+    CHECK(std::equal(list.begin(), list.end(), expected));
+
+    auto front = list.cursor();
+    front.insert(1);
+    front.replace(12);
+    CHECK(list.getEntry(1) == 1);
+    CHECK(list.getEntry(2) == 12);
+    CHECK_THROWS(list.cursor(list.getLength() + 2));
+}
+
+TEST_CASE("testing list iterators and cursors") {
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    testIteratorsAndCursor(array0);
+
+    LinkedList<int> list0;
+    testIteratorsAndCursor(list0);
+
+    const LinkedList<int> constList(list0);
+    CHECK(std::distance(constList.begin(), constList.end()) == list0.getLength());
+}
+
+TEST_CASE("testing linked chain insertion sort") {
+    LinkedList<int> list0;
+    insertionSort(list0);
+    CHECK(list0.isEmpty());
+
+    LinkedList<int> list1;
+    CHECK(list1.insert(1, 10));
+    insertionSort(list1);
+    CHECK(list1.getLength() == 1);
+
+    LinkedList<int> list2;
+    CHECK(list2.insert(1, 10));
+    CHECK(list2.insert(1, 20));
+    insertionSort(list2);
+    CHECK(list2.getEntry(1) == 10);
+    CHECK(list2.getEntry(2) == 20);
+
+    LinkedList<int> list3;
+    CHECK(list3.insert(1, 10));
+    CHECK(list3.insert(1, 20));
+    CHECK(list3.insert(1, 30));
+
+    insertionSort(list3);
+
+    CHECK(list3.getEntry(1) == 10);
+    CHECK(list3.getEntry(2) == 20);
+    CHECK(list3.getEntry(3) == 30);
+
+    LinkedList<int> listRandom;
+    fillRandom(listRandom, 32);
+    insertionSort(listRandom);
+    CHECK(isSorted(listRandom));
+}
+
+TEST_CASE("testing array insertion sort") {
+    ArrayList<int, MAX_ARRAY_SIZE> list0;
+    insertionSort(list0);
+    CHECK(list0.isEmpty());
+
+    ArrayList<int, MAX_ARRAY_SIZE> list1;
+    CHECK(list1.insert(1, 10));
+    insertionSort(list1);
+    CHECK(list1.getLength() == 1);
+
+    ArrayList<int, MAX_ARRAY_SIZE> list2;
+    CHECK(list2.insert(1, 10));
+    CHECK(list2.insert(1, 20));
+    insertionSort(list2);
+    CHECK(list2.getEntry(1) == 10);
+    CHECK(list2.getEntry(2) == 20);
+
+    ArrayList<int, MAX_ARRAY_SIZE> list3;
+    CHECK(list3.insert(1, 10));
+    CHECK(list3.insert(1, 20));
+    CHECK(list3.insert(1, 30));
+
+    insertionSort(list3);
 
     CHECK(list3.getEntry(1) == 10);
     CHECK(list3.getEntry(2) == 20);
     CHECK(list3.getEntry(3) == 30);
 
-    LinkedList<int> listRandom;
-    fillRandom(listRandom, 32);
-    insertionSort(listRandom);
-    CHECK(isSorted(listRandom));
+    ArrayList<int, MAX_ARRAY_SIZE> listRandom;
+    fillRandom(listRandom, 32);
+    insertionSort(listRandom);
+    CHECK(isSorted(listRandom));
+}
+
+// ***** SORTING *****
+
+// sortList picks a sorting algorithm per list implementation. Linked chains are merge sorted by
+// relinking nodes, arrays use a pattern-defeating quicksort, and any other ListADT is copied out,
+// sorted as an array and written back.
+
+constexpr std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+constexpr std::ptrdiff_t NINTHER_THRESHOLD = 128;
+constexpr std::ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+template<class Iterator, class Compare>
+void insertionSortRange(Iterator begin, Iterator end, Compare comp) {
+    if (begin == end) {
+        return;
+    }
+    for (Iterator cur = begin + 1; cur != end; ++cur) {
+        Iterator sift = cur;
+        Iterator siftBefore = cur - 1;
+        if (comp(*sift, *siftBefore)) {
+            auto tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*siftBefore);
+            } while (sift != begin && comp(tmp, *--siftBefore));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up after moving PARTIAL_INSERTION_SORT_LIMIT entries. Returns true if
+// the range ended up sorted.
+template<class Iterator, class Compare>
+bool partialInsertionSort(Iterator begin, Iterator end, Compare comp) {
+    if (begin == end) {
+        return true;
+    }
+    std::ptrdiff_t moved = 0;
+    for (Iterator cur = begin + 1; cur != end; ++cur) {
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+        Iterator sift = cur;
+        Iterator siftBefore = cur - 1;
+        if (comp(*sift, *siftBefore)) {
+            auto tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*siftBefore);
+            } while (sift != begin && comp(tmp, *--siftBefore));
+            *sift = std::move(tmp);
+            moved += cur - sift;
+        }
+    }
+    return true;
+}
+
+template<class Iterator, class Compare>
+void sort2(Iterator a, Iterator b, Compare comp) {
+    if (comp(*b, *a)) {
+        std::iter_swap(a, b);
+    }
+}
+
+template<class Iterator, class Compare>
+void sort3(Iterator a, Iterator b, Iterator c, Compare comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+// Partitions around the pivot at *begin, putting entries equal to it on the right. Returns the
+// pivot's final position and whether the range was already partitioned. The pivot selection
+// guarantees an entry >= pivot to the right, so the first scan needs no bounds check.
+template<class Iterator, class Compare>
+std::pair<Iterator, bool> partitionRight(Iterator begin, Iterator end, Compare comp) {
+    auto pivot = std::move(*begin);
+    Iterator first = begin;
+    Iterator last = end;
+
+    while (comp(*++first, pivot));
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot));
+    } else {
+        while (!comp(*--last, pivot));
+    }
+
+    bool alreadyPartitioned = first >= last;
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot));
+        while (!comp(*--last, pivot));
+    }
+
+    Iterator pivotPosition = first - 1;
+    *begin = std::move(*pivotPosition);
+    *pivotPosition = std::move(pivot);
+    return std::make_pair(pivotPosition, alreadyPartitioned);
+}
+
+// Partitions around the pivot at *begin, putting entries equal to it on the left. Used when the
+// pivot equals the entry before the range, in which case the whole left side equals the pivot.
+template<class Iterator, class Compare>
+Iterator partitionLeft(Iterator begin, Iterator end, Compare comp) {
+    auto pivot = std::move(*begin);
+    Iterator first = begin;
+    Iterator last = end;
+
+    while (comp(pivot, *--last));
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first));
+    } else {
+        while (!comp(pivot, *++first));
+    }
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last));
+        while (!comp(pivot, *++first));
+    }
+
+    Iterator pivotPosition = last;
+    *begin = std::move(*pivotPosition);
+    *pivotPosition = std::move(pivot);
+    return pivotPosition;
+}
+
+template<class Iterator, class Compare>
+void patternDefeatingSortLoop(Iterator begin, Iterator end, Compare comp, int badAllowed, bool leftmost) {
+    while (true) {
+        std::ptrdiff_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            insertionSortRange(begin, end, comp);
+            return;
+        }
+
+        // Median of three, or pseudo median of nine for larger ranges, ends up at *begin.
+        std::ptrdiff_t half = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + half, end - 1, comp);
+            sort3(begin + 1, begin + (half - 1), end - 2, comp);
+            sort3(begin + 2, begin + (half + 1), end - 3, comp);
+            sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+            std::iter_swap(begin, begin + half);
+        } else {
+            sort3(begin + half, begin, end - 1, comp);
+        }
+
+        // Nothing in this range is smaller than the entry just before it. If the pivot equals that
+        // entry, gather everything equal on the left, which then needs no further sorting.
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partitionLeft(begin, end, comp) + 1;
+            continue;
+        }
+
+        auto [pivotPosition, alreadyPartitioned] = partitionRight(begin, end, comp);
+        std::ptrdiff_t leftSize = pivotPosition - begin;
+        std::ptrdiff_t rightSize = end - (pivotPosition + 1);
+        bool highlyUnbalanced = leftSize < size / 8 || rightSize < size / 8;
+
+        if (highlyUnbalanced) {
+            // Too many bad pivots means an adversarial pattern, so fall back to heapsort.
+            if (--badAllowed == 0) {
+                std::make_heap(begin, end, comp);
+                std::sort_heap(begin, end, comp);
+                return;
+            }
+
+            // Otherwise shuffle a few entries to break up the pattern.
+            if (leftSize >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(begin, begin + leftSize / 4);
+                std::iter_swap(pivotPosition - 1, pivotPosition - leftSize / 4);
+                if (leftSize > NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+                    std::iter_swap(pivotPosition - 2, pivotPosition - (leftSize / 4 + 1));
+                    std::iter_swap(pivotPosition - 3, pivotPosition - (leftSize / 4 + 2));
+                }
+            }
+            if (rightSize >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(pivotPosition + 1, pivotPosition + (1 + rightSize / 4));
+                std::iter_swap(end - 1, end - rightSize / 4);
+                if (rightSize > NINTHER_THRESHOLD) {
+                    std::iter_swap(pivotPosition + 2, pivotPosition + (2 + rightSize / 4));
+                    std::iter_swap(pivotPosition + 3, pivotPosition + (3 + rightSize / 4));
+                    std::iter_swap(end - 2, end - (1 + rightSize / 4));
+                    std::iter_swap(end - 3, end - (2 + rightSize / 4));
+                }
+            }
+        } else if (alreadyPartitioned && partialInsertionSort(begin, pivotPosition, comp) &&
+                   partialInsertionSort(pivotPosition + 1, end, comp)) {
+            // A range that needed no swaps is probably sorted already, which the two cheap
+            // insertion sorts just confirmed.
+            return;
+        }
+
+        // Recurse into the left side and loop on the right one.
+        patternDefeatingSortLoop(begin, pivotPosition, comp, badAllowed, leftmost);
+        begin = pivotPosition + 1;
+        leftmost = false;
+    }
+}
+
+// Pattern-defeating quicksort (Orson Peters): quicksort that spots sorted and equal-heavy inputs in
+// linear time and falls back to heapsort on adversarial ones, so it is O(n log n) worst case.
+template<class Iterator, class Compare = std::less<>>
+void patternDefeatingSort(Iterator begin, Iterator end, Compare comp = Compare()) {
+    if (end - begin < 2) {
+        return;
+    }
+    int log2Size = 0;
+    for (auto size = end - begin; size > 1; size >>= 1) {
+        log2Size++;
+    }
+    patternDefeatingSortLoop(begin, end, comp, log2Size, true);
+}
+
+// Calls sort on the list as its concrete type when that is one the sorts below have their own
+// overload for, and returns whether it did. A LinkedList held as ListADT would otherwise be
+// sorted through getEntry and replace, which walk the chain from the head every time.
+template<typename ItemType, class Sort>
+bool sortAsConcreteList(ListADT<ItemType> & list, Sort sort) {
+    if (auto *linkedList = dynamic_cast<LinkedList<ItemType> *>(&list)) {
+        sort(*linkedList);
+        return true;
+    }
+    if (auto *arrayList = dynamic_cast<ArrayList<ItemType, MAX_ARRAY_SIZE> *>(&list)) {
+        sort(*arrayList);
+        return true;
+    }
+    return false;
+}
+
+template<typename ItemType>
+void sortList(ListADT<ItemType> & list) {
+    if (sortAsConcreteList(list, [](auto& concreteList) { sortList(concreteList); })) {
+        return;
+    }
+    std::vector<ItemType> entries;
+    entries.reserve(list.getLength());
+    for (int i = 1; i <= list.getLength(); i++) {
+        entries.push_back(list.getEntry(i));
+    }
+    patternDefeatingSort(entries.begin(), entries.end());
+    for (int i = 1; i <= list.getLength(); i++) {
+        list.replace(i, entries[i - 1]);
+    }
+}
+
+template<typename ItemType, int N>
+void sortList(ArrayList<ItemType, N> & list) {
+    patternDefeatingSort(list.begin(), list.end());
+}
+
+template<typename ItemType>
+void sortList(LinkedList<ItemType> & list) {
+    list.sort();
+}
+
+// ***** ADAPTIVE SORTING *****
+
+// TimSort (Tim Peters): finds the ascending and strictly descending runs already in the data,
+// extends short runs to a minimum length with binary insertion sort and merges runs with galloping,
+// which copies whole blocks once one side keeps winning. Nearly sorted input sorts in close to
+// O(n), the worst case is O(n log n) and equal entries keep their order.
+template<class Iterator, class Compare>
+class TimSorter {
+private:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    static constexpr std::ptrdiff_t MIN_MERGE = 64;
+    static constexpr std::ptrdiff_t MIN_GALLOP = 7;
+
+    struct Run {
+        std::ptrdiff_t start;
+        std::ptrdiff_t length;
+    };
+
+    Iterator base;
+    Compare comp;
+    std::vector<ValueType> buffer; // holds the smaller run during a merge
+    std::vector<Run> runs;         // pending runs, lengths kept roughly like Fibonacci numbers
+    std::ptrdiff_t minGallop;
+
+    // Runs shorter than this are extended with binary insertion sort. Picked so n / minRun is a
+    // power of two or slightly less, which keeps the final merges balanced.
+    static std::ptrdiff_t computeMinRun(std::ptrdiff_t n) {
+        std::ptrdiff_t lowBits = 0;
+        while (n >= MIN_MERGE) {
+            lowBits |= n & 1;
+            n >>= 1;
+        }
+        return n + lowBits;
+    }
+
+    // Length of the run starting at first. A strictly descending run is reversed in place; requiring
+    // strictness keeps the reversal from reordering equal entries.
+    std::ptrdiff_t countRunAndMakeAscending(Iterator first, Iterator last) {
+        Iterator runEnd = first + 1;
+        if (runEnd == last) {
+            return 1;
+        }
+        if (comp(*runEnd, *first)) {
+            while (runEnd != last && comp(*runEnd, *(runEnd - 1))) {
+                ++runEnd;
+            }
+            std::reverse(first, runEnd);
+        } else {
+            while (runEnd != last && !comp(*runEnd, *(runEnd - 1))) {
+                ++runEnd;
+            }
+        }
+        return runEnd - first;
+    }
+
+    // Sorts [first, last) given that [first, sortedEnd) is already sorted. Insert points are found
+    // by binary search after the last equal entry, so the sort is stable.
+    void binaryInsertionSort(Iterator first, Iterator last, Iterator sortedEnd) {
+        for (Iterator cur = sortedEnd; cur != last; ++cur) {
+            Iterator insertAt = std::upper_bound(first, cur, *cur, comp);
+            if (insertAt != cur) {
+                ValueType pivot = std::move(*cur);
+                std::move_backward(insertAt, cur, cur + 1);
+                *insertAt = std::move(pivot);
+            }
+        }
+    }
+
+    // Galloping searches probe 1, 3, 7, 15, ... entries from one end before a binary search, so
+    // they cost O(log k) when the answer is k entries from that end.
+
+    // First entry in [first, last) greater than key, probing from the left.
+    template<class It>
+    It gallopUpperFromLeft(It first, It last, const ValueType &key) {
+        std::ptrdiff_t length = last - first, lo = 0, hi = 1;
+        while (hi <= length && !comp(key, first[hi - 1])) {
+            lo = hi;
+            hi = hi * 2 + 1;
+        }
+        return std::upper_bound(first + lo, first + std::min(hi, length), key, comp);
+    }
+
+    // First entry in [first, last) not less than key, probing from the left.
+    template<class It>
+    It gallopLowerFromLeft(It first, It last, const ValueType &key) {
+        std::ptrdiff_t length = last - first, lo = 0, hi = 1;
+        while (hi <= length && comp(first[hi - 1], key)) {
+            lo = hi;
+            hi = hi * 2 + 1;
+        }
+        return std::lower_bound(first + lo, first + std::min(hi, length), key, comp);
+    }
+
+    // First entry in [first, last) not less than key, probing from the right.
+    template<class It>
+    It gallopLowerFromRight(It first, It last, const ValueType &key) {
+        std::ptrdiff_t length = last - first, lo = 0, hi = 1;
+        while (hi <= length && !comp(last[-hi], key)) {
+            lo = hi;
+            hi = hi * 2 + 1;
+        }
+        return std::lower_bound(last - std::min(hi, length), last - lo, key, comp);
+    }
+
+    // First entry in [first, last) greater than key, probing from the right.
+    template<class It>
+    It gallopUpperFromRight(It first, It last, const ValueType &key) {
+        std::ptrdiff_t length = last - first, lo = 0, hi = 1;
+        while (hi <= length && comp(key, last[-hi])) {
+            lo = hi;
+            hi = hi * 2 + 1;
+        }
+        return std::upper_bound(last - std::min(hi, length), last - lo, key, comp);
+    }
+
+    // Adjusts minGallop after a galloping round; galloping that pays off makes it easier to enter.
+    // Returns false once galloping stops paying off and merging should go back to one at a time.
+    bool keepGalloping(std::ptrdiff_t firstCount, std::ptrdiff_t secondCount) {
+        if (firstCount < MIN_GALLOP && secondCount < MIN_GALLOP) {
+            minGallop++;
+            return false;
+        }
+        if (minGallop > 1) {
+            minGallop--;
+        }
+        return true;
+    }
+
+    // Merges adjacent sorted runs [aFirst, bFirst) and [bFirst, bLast) where the first is the
+    // shorter one. It is moved to the buffer and the merge fills the range from the left.
+    void mergeLow(Iterator aFirst, Iterator bFirst, Iterator bLast) {
+        buffer.assign(std::make_move_iterator(aFirst), std::make_move_iterator(bFirst));
+        auto a = buffer.begin();
+        Iterator b = bFirst;
+        Iterator dest = aFirst;
+        while (a != buffer.end() && b != bLast) {
+            std::ptrdiff_t aWins = 0, bWins = 0;
+            while (a != buffer.end() && b != bLast && aWins < minGallop && bWins < minGallop) {
+                if (comp(*b, *a)) {
+                    *dest++ = std::move(*b++);
+                    bWins++;
+                    aWins = 0;
+                } else {
+                    *dest++ = std::move(*a++);
+                    aWins++;
+                    bWins = 0;
+                }
+            }
+            while (a != buffer.end() && b != bLast) {
+                auto aBlockEnd = gallopUpperFromLeft(a, buffer.end(), *b);
+                std::ptrdiff_t aCount = aBlockEnd - a;
+                dest = std::move(a, aBlockEnd, dest);
+                a = aBlockEnd;
+                if (a == buffer.end()) {
+                    break;
+                }
+                Iterator bBlockEnd = gallopLowerFromLeft(b, bLast, *a);
+                std::ptrdiff_t bCount = bBlockEnd - b;
+                dest = std::move(b, bBlockEnd, dest);
+                b = bBlockEnd;
+                if (!keepGalloping(aCount, bCount)) {
+                    break;
+                }
+            }
+        }
+        // Whatever is left of b is already in place.
+        std::move(a, buffer.end(), dest);
+    }
+
+    // Like mergeLow for when the second run is the shorter one; fills the range from the right.
+    void mergeHigh(Iterator aFirst, Iterator bFirst, Iterator bLast) {
+        buffer.assign(std::make_move_iterator(bFirst), std::make_move_iterator(bLast));
+        Iterator a = bFirst;   // one past the last unmerged entry of a
+        auto b = buffer.end(); // one past the last unmerged entry of b
+        Iterator dest = bLast;
+        while (a != aFirst && b != buffer.begin()) {
+            std::ptrdiff_t aWins = 0, bWins = 0;
+            while (a != aFirst && b != buffer.begin() && aWins < minGallop && bWins < minGallop) {
+                if (comp(*(b - 1), *(a - 1))) {
+                    *--dest = std::move(*--a);
+                    aWins++;
+                    bWins = 0;
+                } else {
+                    *--dest = std::move(*--b);
+                    bWins++;
+                    aWins = 0;
+                }
+            }
+            while (a != aFirst && b != buffer.begin()) {
+                auto bBlockStart = gallopLowerFromRight(buffer.begin(), b, *(a - 1));
+                std::ptrdiff_t bCount = b - bBlockStart;
+                dest = std::move_backward(bBlockStart, b, dest);
+                b = bBlockStart;
+                if (b == buffer.begin()) {
+                    break;
+                }
+                Iterator aBlockStart = gallopUpperFromRight(aFirst, a, *(b - 1));
+                std::ptrdiff_t aCount = a - aBlockStart;
+                dest = std::move_backward(aBlockStart, a, dest);
+                a = aBlockStart;
+                if (!keepGalloping(aCount, bCount)) {
+                    break;
+                }
+            }
+        }
+        // Whatever is left of a is already in place.
+        std::move_backward(buffer.begin(), b, dest);
+    }
+
+    // Merges pending runs i and i + 1.
+    void mergeAt(size_t i) {
+        Iterator aFirst = base + runs[i].start;
+        Iterator bFirst = base + runs[i + 1].start;
+        Iterator bLast = bFirst + runs[i + 1].length;
+        runs[i].length += runs[i + 1].length;
+        runs.erase(runs.begin() + i + 1);
+
+        // Entries of a that are <= the first of b and entries of b that are >= the last of a
+        // are already where they belong.
+        aFirst = gallopUpperFromLeft(aFirst, bFirst, *bFirst);
+        if (aFirst == bFirst) {
+            return;
+        }
+        bLast = gallopLowerFromRight(bFirst, bLast, *(bFirst - 1));
+        if (bFirst - aFirst <= bLast - bFirst) {
+            mergeLow(aFirst, bFirst, bLast);
+        } else {
+            mergeHigh(aFirst, bFirst, bLast);
+        }
+    }
+
+    // Merges pending runs until each run is longer than the next two combined, which bounds the
+    // stack to O(log n) runs while still merging runs of similar size.
+    void mergeCollapse() {
+        while (runs.size() > 1) {
+            size_t n = runs.size() - 2;
+            if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length) ||
+                (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length)) {
+                if (runs[n - 1].length < runs[n + 1].length) {
+                    n--;
+                }
+            } else if (runs[n].length > runs[n + 1].length) {
+                break;
+            }
+            mergeAt(n);
+        }
+    }
+
+    void mergeForceCollapse() {
+        while (runs.size() > 1) {
+            size_t n = runs.size() - 2;
+            if (n > 0 && runs[n - 1].length < runs[n + 1].length) {
+                n--;
+            }
+            mergeAt(n);
+        }
+    }
+
+public:
+    TimSorter(Iterator base, Compare comp) : base(base), comp(comp), minGallop(MIN_GALLOP) {}
+
+    void sort(std::ptrdiff_t n) {
+        if (n < 2) {
+            return;
+        }
+        if (n < MIN_MERGE) {
+            std::ptrdiff_t runLength = countRunAndMakeAscending(base, base + n);
+            binaryInsertionSort(base, base + n, base + runLength);
+            return;
+        }
+
+        std::ptrdiff_t minRun = computeMinRun(n);
+        for (std::ptrdiff_t lo = 0; lo < n;) {
+            std::ptrdiff_t runLength = countRunAndMakeAscending(base + lo, base + n);
+            if (runLength < minRun) {
+                std::ptrdiff_t forced = std::min(minRun, n - lo);
+                binaryInsertionSort(base + lo, base + lo + forced, base + lo + runLength);
+                runLength = forced;
+            }
+            runs.push_back(Run{lo, runLength});
+            mergeCollapse();
+            lo += runLength;
+        }
+        mergeForceCollapse();
+    }
+};
+
+template<class Iterator, class Compare = std::less<>>
+void timSort(Iterator begin, Iterator end, Compare comp = Compare()) {
+    TimSorter<Iterator, Compare>(begin, comp).sort(end - begin);
+}
+
+template<typename ItemType>
+void adaptiveSort(ListADT<ItemType> & list) {
+    if (sortAsConcreteList(list, [](auto& concreteList) { adaptiveSort(concreteList); })) {
+        return;
+    }
+    std::vector<ItemType> entries;
+    entries.reserve(list.getLength());
+    for (int i = 1; i <= list.getLength(); i++) {
+        entries.push_back(list.getEntry(i));
+    }
+    timSort(entries.begin(), entries.end());
+    for (int i = 1; i <= list.getLength(); i++) {
+        list.replace(i, entries[i - 1]);
+    }
+}
+
+template<typename ItemType, int N>
+void adaptiveSort(ArrayList<ItemType, N> & list) {
+    timSort(list.begin(), list.end());
+}
+
+// The chain is copied out and back through its iterators, both single passes.
+template<typename ItemType>
+void adaptiveSort(LinkedList<ItemType> & list) {
+    std::vector<ItemType> entries(list.begin(), list.end());
+    timSort(entries.begin(), entries.end());
+    std::move(entries.begin(), entries.end(), list.begin());
+}
+
+// Insertion sort that finds the insert point by binary search and places an entry after the ones
+// equal to it, so it is stable. An entry already in order costs a single comparison.
+template<typename ItemType>
+void binaryInsertionSort(ListADT<ItemType> & list) {
+    for (int i = 2; i <= list.getLength(); i++) {
+        ItemType tempVariable = list.getEntry(i);
+        if (!(tempVariable < list.getEntry(i - 1))) {
+            continue;
+        }
+        int low = 1;
+        int high = i - 1; // the insert point is in [low, high]
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (tempVariable < list.getEntry(middle)) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+        list.remove(i);
+        list.insert(low, tempVariable);
+    }
+}
+
+// Fills the list with one of several input patterns that trip up naive quicksorts.
+template<class ListType>
+void fillPattern(ListType & list, int pattern, int n) {
+    list.clear();
+    for (int i = 0; i < n; i++) {
+        int value;
+        switch (pattern) {
+            case 0: value = std::rand(); break;           // random
+            case 1: value = i; break;                     // sorted
+            case 2: value = n - i; break;                 // reversed
+            case 3: value = 7; break;                     // all equal
+            case 4: value = i < n / 2 ? i : n - i; break; // organ pipe
+            case 5: value = std::rand() % 4; break;       // few distinct values
+            default: value = std::rand() % 50 == 0 ? std::rand() % n : i; break; // nearly sorted
+        }
+        list.insert(i + 1, value);
+    }
+}
+
+template<class ListType, class Sort>
+void testSortList(ListType & list, Sort sort) {
+    for (int pattern = 0; pattern <= 6; pattern++) {
+        for (int n : {0, 1, 2, 23, 24, 200, 3000}) {
+            fillPattern(list, pattern, n);
+            std::vector<int> expected;
+            for (int i = 1; i <= list.getLength(); i++) {
+                expected.push_back(list.getEntry(i));
+            }
+            std::sort(expected.begin(), expected.end());
+
+            sort(list);
+            REQUIRE(list.getLength() == n);
+            bool allMatch = true;
+            for (int i = 1; i <= n; i++) {
+                allMatch = allMatch && list.getEntry(i) == expected[i - 1];
+            }
+            CHECK(allMatch);
+        }
+    }
+}
+
+TEST_CASE("testing sorting engine") {
+    std::srand(34);
+
+    auto sortAny = [](auto& list) { sortList(list); };
+
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    testSortList(array0, sortAny);
+
+    LinkedList<int> list0;
+    testSortList(list0, sortAny);
+
+    GapBufferList<int> gapBuffer0;
+    testSortList(gapBuffer0, sortAny);
+
+    // Held as ListADT, the lists still get their own sorts.
+    auto sortAsListADT = [](ListADT<int>& list) { sortList(list); };
+    testSortList(array0, sortAsListADT);
+    testSortList(list0, sortAsListADT);
+
+    // The linked chain merge sort keeps equal keys in their original order.
+    LinkedList<std::pair<int, int>> pairs;
+    for (int i = 0; i < 100; i++) {
+        pairs.insert(i + 1, std::make_pair(i % 5, i));
+    }
+    pairs.sort([](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+    CHECK(std::is_sorted(pairs.begin(), pairs.end()));
+}
+
+TEST_CASE("testing adaptive sort") {
+    std::srand(35);
+    auto sortAny = [](auto& list) { adaptiveSort(list); };
+
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    testSortList(array0, sortAny);
+
+    LinkedList<int> list0;
+    testSortList(list0, sortAny);
+
+    GapBufferList<int> gapBuffer0;
+    testSortList(gapBuffer0, sortAny);
+
+    auto sortAsListADT = [](ListADT<int>& list) { adaptiveSort(list); };
+    testSortList(array0, sortAsListADT);
+    testSortList(list0, sortAsListADT);
+
+    // Long runs with equal keys exercise galloping and must keep equal keys in order.
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 5000; i++) {
+        int key = i < 2500 ? i / 10 : (i - 2500) / 7;
+        pairs.push_back(std::make_pair(key, i));
+    }
+    timSort(pairs.begin(), pairs.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first < b.first;
+    });
+    CHECK(std::is_sorted(pairs.begin(), pairs.end()));
+
+    ArrayList<int, MAX_ARRAY_SIZE> small;
+    testSortList(small, [](auto& list) { binaryInsertionSort(list); });
+}
+
+// ***** PARALLEL SORTING *****
+
+// Calls work(0) ... work(count - 1), each on its own thread, and waits for all of them.
+template<class Work>
+void runInParallel(int count, Work work) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (int i = 0; i < count; i++) {
+        threads.emplace_back(work, i);
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+constexpr std::ptrdiff_t MIN_PARALLEL_CHUNK = 1 << 14;
+
+// Parallel sort by regular sampling. Each thread sorts one chunk, then p - 1 splitters picked
+// from evenly spaced samples of the sorted chunks cut every chunk into p pieces. Thread j merges
+// the j-th piece of every chunk straight into its slot of a buffer, so the merge is one p-way pass
+// done by all threads at once instead of log p rounds of pairwise merges.
+template<class Iterator, class Compare = std::less<>>
+void parallelSortRange(Iterator begin, Iterator end, int threadCount, Compare comp = Compare()) {
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+    const std::ptrdiff_t n = end - begin;
+    const int p = static_cast<int>(std::min<std::ptrdiff_t>(std::max(threadCount, 1), n / MIN_PARALLEL_CHUNK));
+    if (p <= 1) {
+        patternDefeatingSort(begin, end, comp);
+        return;
+    }
+
+    std::vector<std::ptrdiff_t> chunkStart(p + 1);
+    for (int i = 0; i <= p; i++) {
+        chunkStart[i] = n * i / p;
+    }
+    runInParallel(p, [&](int i) {
+        patternDefeatingSort(begin + chunkStart[i], begin + chunkStart[i + 1], comp);
+    });
+
+    // p samples per chunk; every p-th of the sorted samples becomes a splitter.
+    std::vector<ValueType> samples;
+    samples.reserve(static_cast<size_t>(p) * p);
+    for (int i = 0; i < p; i++) {
+        std::ptrdiff_t length = chunkStart[i + 1] - chunkStart[i];
+        for (int k = 0; k < p; k++) {
+            samples.push_back(begin[chunkStart[i] + length * k / p]);
+        }
+    }
+    std::sort(samples.begin(), samples.end(), comp);
+    std::vector<ValueType> splitters;
+    for (int j = 1; j < p; j++) {
+        splitters.push_back(samples[static_cast<size_t>(j) * p + p / 2]);
+    }
+
+    // cut[i][j] is where piece j of chunk i starts; piece j holds entries in [splitter j-1, splitter j).
+    std::vector<std::vector<std::ptrdiff_t>> cut(p, std::vector<std::ptrdiff_t>(p + 1));
+    runInParallel(p, [&](int i) {
+        cut[i][0] = chunkStart[i];
+        for (int j = 1; j < p; j++) {
+            cut[i][j] = std::lower_bound(begin + cut[i][j - 1], begin + chunkStart[i + 1], splitters[j - 1], comp) - begin;
+        }
+        cut[i][p] = chunkStart[i + 1];
+    });
+
+    std::vector<std::ptrdiff_t> outputStart(p + 1, 0);
+    for (int j = 0; j < p; j++) {
+        outputStart[j + 1] = outputStart[j];
+        for (int i = 0; i < p; i++) {
+            outputStart[j + 1] += cut[i][j + 1] - cut[i][j];
+        }
+    }
+
+    std::vector<ValueType> buffer(n);
+    runInParallel(p, [&](int j) {
+        // Min-heap of chunk indices keyed by the next entry of each chunk's piece.
+        std::vector<std::ptrdiff_t> next(p), last(p);
+        std::vector<int> heap;
+        for (int i = 0; i < p; i++) {
+            next[i] = cut[i][j];
+            last[i] = cut[i][j + 1];
+            if (next[i] < last[i]) {
+                heap.push_back(i);
+            }
+        }
+        auto later = [&](int a, int b) { return comp(begin[next[b]], begin[next[a]]); };
+        std::make_heap(heap.begin(), heap.end(), later);
+
+        auto out = buffer.begin() + outputStart[j];
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            int i = heap.back();
+            *out++ = std::move(begin[next[i]++]);
+            if (next[i] < last[i]) {
+                std::push_heap(heap.begin(), heap.end(), later);
+            } else {
+                heap.pop_back();
+            }
+        }
+    });
+
+    runInParallel(p, [&](int j) {
+        std::move(buffer.begin() + outputStart[j], buffer.begin() + outputStart[j + 1], begin + outputStart[j]);
+    });
+}
+
+int defaultThreadCount() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+template<typename ItemType>
+void parallelSort(ListADT<ItemType> & list, int threadCount = defaultThreadCount()) {
+    if (sortAsConcreteList(list, [threadCount](auto& concreteList) { parallelSort(concreteList, threadCount); })) {
+        return;
+    }
+    std::vector<ItemType> entries;
+    entries.reserve(list.getLength());
+    for (int i = 1; i <= list.getLength(); i++) {
+        entries.push_back(list.getEntry(i));
+    }
+    parallelSortRange(entries.begin(), entries.end(), threadCount);
+    for (int i = 1; i <= list.getLength(); i++) {
+        list.replace(i, entries[i - 1]);
+    }
+}
+
+template<typename ItemType, int N>
+void parallelSort(ArrayList<ItemType, N> & list, int threadCount = defaultThreadCount()) {
+    parallelSortRange(list.begin(), list.end(), threadCount);
+}
+
+template<typename ItemType>
+void parallelSort(LinkedList<ItemType> & list, int threadCount = defaultThreadCount()) {
+    std::vector<ItemType> entries(list.begin(), list.end());
+    parallelSortRange(entries.begin(), entries.end(), threadCount);
+    std::move(entries.begin(), entries.end(), list.begin());
+}
+
+TEST_CASE("testing parallel sort") {
+    std::srand(36);
+    auto sortAny = [](auto& list) { parallelSort(list, 4); };
+
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    testSortList(array0, sortAny);
+
+    GapBufferList<int> gapBuffer0;
+    testSortList(gapBuffer0, sortAny);
+
+    auto sortAsListADT = [](ListADT<int>& list) { parallelSort(list, 4); };
+    LinkedList<int> list0;
+    testSortList(array0, sortAsListADT);
+    testSortList(list0, sortAsListADT);
+
+    // Large enough to split across threads, with plenty of duplicate keys.
+    for (int distinct : {3, 1000, RAND_MAX}) {
+        ArrayList<int, MAX_ARRAY_SIZE> array1;
+        LinkedList<int> list1;
+        std::vector<int> expected;
+        for (int i = 0; i < 200000; i++) {
+            int value = std::rand() % distinct;
+            array1.insert(i + 1, value);
+            list1.insert(1, value);
+            expected.push_back(value);
+        }
+        std::sort(expected.begin(), expected.end());
+        parallelSort(array1, 7);
+        parallelSort(list1, 3);
+        CHECK(std::equal(array1.begin(), array1.end(), expected.begin(), expected.end()));
+        CHECK(std::equal(list1.begin(), list1.end(), expected.begin(), expected.end()));
+    }
+}
+
+// Skipped by default, run the executable with --no-skip to see the timings.
+TEST_CASE("benchmark parallel sort" * doctest::skip()) {
+    const int n = 20000000;
+    std::vector<int> input(n);
+    std::mt19937 generator(36);
+    for (int &value : input) {
+        value = static_cast<int>(generator());
+    }
+
+    int cores = defaultThreadCount();
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    double singleThreadSeconds = 0.0;
+    for (int threads : threadCounts) {
+        std::vector<int> data = input;
+        double seconds = secondsToRun([&]() { parallelSortRange(data.begin(), data.end(), threads); });
+        CHECK(std::is_sorted(data.begin(), data.end()));
+        if (threads == 1) {
+            singleThreadSeconds = seconds;
+        }
+        std::cout << threads << " threads: " << n / seconds << " ints/sec, speedup "
+                  << singleThreadSeconds / seconds << std::endl;
+    }
+}
+
+// ***** RADIX SORTING *****
+
+// Maps an integer key to an unsigned one with the same ordering by flipping the sign bit.
+template<typename Key>
+std::make_unsigned_t<Key> radixKey(Key key) {
+    using UnsignedKey = std::make_unsigned_t<Key>;
+    UnsignedKey bits = static_cast<UnsignedKey>(key);
+    if constexpr (std::is_signed_v<Key>) {
+        bits ^= UnsignedKey{1} << (sizeof(Key) * 8 - 1);
+    }
+    return bits;
+}
+
+// LSD radix sort for 32 and 64 bit integers with 8 bit digits. Each pass scatters between the
+// data and a ping-pong buffer, every thread writing its slice to offsets from the prefix sums of
+// the per-slice digit counts, which keeps the sort stable. Passes whose digit is the same for every
+// key are skipped. On one thread a single read up front counts every digit, since the one slice
+// always holds every key. With several threads keys move between slices after each pass, so each
+// pass recounts its own digit per slice instead.
+template<typename Key>
+void radixSortRange(Key *data, std::ptrdiff_t n, int threadCount = 1) {
+    static_assert(std::is_integral_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8),
+                  "radixSortRange sorts 32 and 64 bit integers");
+    constexpr int DIGIT_BITS = 8;
+    constexpr int BUCKETS = 1 << DIGIT_BITS;
+    constexpr int PASSES = sizeof(Key) * 8 / DIGIT_BITS;
+    using Histogram = std::array<std::array<std::ptrdiff_t, BUCKETS>, PASSES>;
+
+    if (n < 2) {
+        return;
+    }
+    const int p = static_cast<int>(std::min<std::ptrdiff_t>(std::max(threadCount, 1),
+                                                            std::max<std::ptrdiff_t>(1, n / MIN_PARALLEL_CHUNK)));
+    std::vector<std::ptrdiff_t> sliceStart(p + 1);
+    for (int t = 0; t <= p; t++) {
+        sliceStart[t] = n * t / p;
+    }
+
+    std::vector<Histogram> histograms(p);
+    if (p == 1) {
+        Histogram &histogram = histograms[0];
+        for (auto &digitCounts : histogram) {
+            digitCounts.fill(0);
+        }
+        for (std::ptrdiff_t i = 0; i < n; i++) {
+            auto bits = radixKey(data[i]);
+            for (int pass = 0; pass < PASSES; pass++) {
+                histogram[pass][(bits >> (pass * DIGIT_BITS)) & (BUCKETS - 1)]++;
+            }
+        }
+    }
+
+    std::vector<Key> buffer(n);
+    Key *from = data;
+    Key *to = buffer.data();
+    for (int pass = 0; pass < PASSES; pass++) {
+        const int shift = pass * DIGIT_BITS;
+        if (p > 1) {
+            runInParallel(p, [&, shift](int t) {
+                std::array<std::ptrdiff_t, BUCKETS> &digitCounts = histograms[t][pass];
+                digitCounts.fill(0);
+                for (std::ptrdiff_t i = sliceStart[t]; i < sliceStart[t + 1]; i++) {
+                    digitCounts[(radixKey(from[i]) >> shift) & (BUCKETS - 1)]++;
+                }
+            });
+        }
+
+        // Every key shares this digit, so the pass would not move anything.
+        bool trivialPass = false;
+        for (int digit = 0; digit < BUCKETS && !trivialPass; digit++) {
+            std::ptrdiff_t total = 0;
+            for (int t = 0; t < p; t++) {
+                total += histograms[t][pass][digit];
+            }
+            trivialPass = total == n;
+        }
+        if (trivialPass) {
+            continue;
+        }
+
+        // Thread t starts each bucket after the same bucket of threads 0 .. t-1.
+        std::vector<std::array<std::ptrdiff_t, BUCKETS>> offsets(p);
+        std::ptrdiff_t next = 0;
+        for (int digit = 0; digit < BUCKETS; digit++) {
+            for (int t = 0; t < p; t++) {
+                offsets[t][digit] = next;
+                next += histograms[t][pass][digit];
+            }
+        }
+
+        runInParallel(p, [&, shift](int t) {
+            std::array<std::ptrdiff_t, BUCKETS> &offset = offsets[t];
+            for (std::ptrdiff_t i = sliceStart[t]; i < sliceStart[t + 1]; i++) {
+                to[offset[(radixKey(from[i]) >> shift) & (BUCKETS - 1)]++] = from[i];
+            }
+        });
+        std::swap(from, to);
+    }
+
+    if (from != data) {
+        std::copy(from, from + n, data);
+    }
+}
+
+template<typename ItemType>
+void radixSort(ListADT<ItemType> & list, int threadCount = defaultThreadCount()) {
+    if (sortAsConcreteList(list, [threadCount](auto& concreteList) { radixSort(concreteList, threadCount); })) {
+        return;
+    }
+    std::vector<ItemType> entries;
+    entries.reserve(list.getLength());
+    for (int i = 1; i <= list.getLength(); i++) {
+        entries.push_back(list.getEntry(i));
+    }
+    radixSortRange(entries.data(), static_cast<std::ptrdiff_t>(entries.size()), threadCount);
+    for (int i = 1; i <= list.getLength(); i++) {
+        list.replace(i, entries[i - 1]);
+    }
+}
+
+template<typename ItemType, int N>
+void radixSort(ArrayList<ItemType, N> & list, int threadCount = defaultThreadCount()) {
+    radixSortRange(list.begin(), list.getLength(), threadCount);
+}
+
+template<typename ItemType>
+void radixSort(LinkedList<ItemType> & list, int threadCount = defaultThreadCount()) {
+    std::vector<ItemType> entries(list.begin(), list.end());
+    radixSortRange(entries.data(), static_cast<std::ptrdiff_t>(entries.size()), threadCount);
+    std::copy(entries.begin(), entries.end(), list.begin());
+}
+
+TEST_CASE("testing radix sort") {
+    std::srand(37);
+    auto sortAny = [](auto& list) { radixSort(list, 3); };
+
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    testSortList(array0, sortAny);
+
+    LinkedList<int> list0;
+    testSortList(list0, sortAny);
+
+    auto sortAsListADT = [](ListADT<int>& list) { radixSort(list, 3); };
+    testSortList(array0, sortAsListADT);
+    testSortList(list0, sortAsListADT);
+
+    // Negative and positive 64 bit keys across every digit, split over several threads.
+    std::mt19937_64 generator(37);
+    std::vector<long long> keys(100000);
+    for (long long &key : keys) {
+        key = static_cast<long long>(generator());
+    }
+    keys[0] = std::numeric_limits<long long>::min();
+    keys[1] = std::numeric_limits<long long>::max();
+    std::vector<long long> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    radixSortRange(keys.data(), static_cast<std::ptrdiff_t>(keys.size()), 5);
+    CHECK(keys == expected);
+
+    std::vector<unsigned> small = {3, 1, 2, 1};
+    radixSortRange(small.data(), 4);
+    CHECK(small == std::vector<unsigned>{1, 1, 2, 3});
+}
+
+// Skipped by default, run the executable with --no-skip to see the timings.
+TEST_CASE("benchmark radix sort" * doctest::skip()) {
+    const int n = 20000000;
+    std::mt19937 generator(37);
+    std::vector<int> data32(n);
+    for (int &value : data32) {
+        value = static_cast<int>(generator());
+    }
+    std::vector<long long> data64(data32.begin(), data32.end());
+    for (long long &value : data64) {
+        value = value * 4294967296LL + static_cast<long long>(generator());
+    }
+
+    int threads = defaultThreadCount();
+    double seconds32 = secondsToRun([&]() { radixSortRange(data32.data(), n, threads); });
+    double seconds64 = secondsToRun([&]() { radixSortRange(data64.data(), n, threads); });
+    CHECK(std::is_sorted(data32.begin(), data32.end()));
+    CHECK(std::is_sorted(data64.begin(), data64.end()));
+    std::cout << "32 bit keys: " << n / seconds32 / threads << " keys/sec per core on " << threads << " threads" << std::endl;
+    std::cout << "64 bit keys: " << n / seconds64 / threads << " keys/sec per core on " << threads << " threads" << std::endl;
+}
+
+// ***** BULK LOADING *****
+
+// SplitMix64 (Steele, Lea and Flood). Hashing seed and index together gives every entry its own
+// random value, so a fill can be split across threads and still match a single threaded one.
+std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// A non-negative int like std::rand returns, for entry index of a fill seeded with seed.
+int randomEntry(std::uint64_t seed, std::int64_t index) {
+    return static_cast<int>(splitMix64(splitMix64(seed) + static_cast<std::uint64_t>(index)) >> 33);
+}
+
+// Replaces the contents with n seeded random entries, filling slices of the array in parallel.
+template<int N>
+void fillRandom(ArrayList<int, N> & list, int n, std::uint64_t seed, int threadCount = defaultThreadCount()) {
+    list.resize(n);
+    int *entries = list.begin();
+    const int p = static_cast<int>(std::min<std::ptrdiff_t>(std::max(threadCount, 1),
+                                                            std::max<std::ptrdiff_t>(1, n / MIN_PARALLEL_CHUNK)));
+    runInParallel(p, [&](int t) {
+        std::int64_t last = static_cast<std::int64_t>(n) * (t + 1) / p;
+        for (std::int64_t i = static_cast<std::int64_t>(n) * t / p; i < last; i++) {
+            entries[i] = randomEntry(seed, i);
+        }
+    });
+}
+
+// Replaces the contents with n seeded random entries, linked in one pass.
+void fillRandom(LinkedList<int> & list, int n, std::uint64_t seed) {
+    list = LinkedList<int>::fromGenerator(n, [seed](int i) { return randomEntry(seed, i); });
+}
+
+TEST_CASE("testing bulk loading") {
+    std::vector<int> source = {5, 3, 8, 1};
+    ArrayList<int, MAX_ARRAY_SIZE> array0(source.begin(), source.end());
+    LinkedList<int> list0(source.begin(), source.end());
+    CHECK(std::equal(array0.begin(), array0.end(), source.begin(), source.end()));
+    CHECK(std::equal(list0.begin(), list0.end(), source.begin(), source.end()));
+    CHECK(list0.getLength() == 4);
+    CHECK(list0.insert(5, 9));
+    CHECK(list0.getEntry(5) == 9);
+
+    auto squares = ArrayList<int, MAX_ARRAY_SIZE>::fromGenerator(100, [](int i) { return i * i; });
+    CHECK(squares.getLength() == 100);
+    CHECK(squares.getEntry(100) == 99 * 99);
+    auto evens = LinkedList<int>::fromGenerator(100, [](int i) { return 2 * i; });
+    CHECK(evens.getLength() == 100);
+    CHECK(evens.getEntry(100) == 198);
+
+    squares.resize(10);
+    CHECK(squares.getLength() == 10);
+    squares.resize(12);
+    CHECK(squares.getEntry(12) == 0);
+
+    // The same seed gives the same entries whatever the thread count.
+    ArrayList<int, MAX_ARRAY_SIZE> oneThread;
+    ArrayList<int, MAX_ARRAY_SIZE> fourThreads;
+    LinkedList<int> linked;
+    fillRandom(oneThread, 100000, 38, 1);
+    fillRandom(fourThreads, 100000, 38, 4);
+    fillRandom(linked, 100000, 38);
+    CHECK(oneThread.getLength() == 100000);
+    CHECK(std::equal(oneThread.begin(), oneThread.end(), fourThreads.begin(), fourThreads.end()));
+    CHECK(std::equal(oneThread.begin(), oneThread.end(), linked.begin(), linked.end()));
+    CHECK(std::all_of(oneThread.begin(), oneThread.end(), [](int value) { return value >= 0; }));
+    CHECK_FALSE(isSorted(oneThread));
+}
+
+// Skipped by default, run the executable with --no-skip to see the timings.
+TEST_CASE("benchmark bulk loading" * doctest::skip()) {
+    const int n = 10000000;
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    LinkedList<int> list0;
+    double arraySeconds = secondsToRun([&]() { fillRandom(array0, n, 38); });
+    double listSeconds = secondsToRun([&]() { fillRandom(list0, n, 38); });
+    CHECK(array0.getLength() == n);
+    CHECK(list0.getLength() == n);
+    std::cout << "fill " << n << " entries: array " << arraySeconds * 1000 << " ms, linked chain "
+              << listSeconds * 1000 << " ms" << std::endl;
+}
+
+// ***** PERSISTENT LIST *****
+
+// A list whose versions share structure. Entries live in an immutable treap (a binary search tree
+// on position that is also a heap on random priorities, so it stays O(log n) deep) and every
+// change copies only the O(log n) nodes on its path, leaving the old version intact. Copying a
+// PersistentList, or calling snapshot, is O(1) and the copy never changes afterwards, so a writer
+// can hand snapshots to reader threads and keep mutating without locks or deep copies. The list
+// object itself is not synchronized: take snapshots on the writer's thread and pass them on.
+template<typename T>
+class PersistentList final : public ListADT<T> {
+private:
+    struct TreapNode;
+    using NodePtr = std::shared_ptr<const TreapNode>;
+
+    struct TreapNode {
+        T item;
+        std::uint32_t priority;
+        int size; // entries in this subtree
+        NodePtr left;
+        NodePtr right;
+
+        TreapNode(const T &item, std::uint32_t priority, NodePtr left, NodePtr right)
+                : item(item), priority(priority), size(1 + sizeOf(left) + sizeOf(right)),
+                  left(std::move(left)), right(std::move(right)) {}
+    };
+
+    NodePtr rootPtr;
+    std::mt19937 priorityGenerator;
+
+    static int sizeOf(const NodePtr &node) {
+        return node != nullptr ? node->size : 0;
+    }
+
+    static NodePtr makeNode(const T &item, std::uint32_t priority, NodePtr left, NodePtr right) {
+        return std::make_shared<const TreapNode>(item, priority, std::move(left), std::move(right));
+    }
+
+    // Splits into the first count entries and the rest, copying only the nodes along the cut.
+    static std::pair<NodePtr, NodePtr> split(const NodePtr &node, int count) {
+        if (node == nullptr) {
+            return {nullptr, nullptr};
+        }
+        int leftSize = sizeOf(node->left);
+        if (count <= leftSize) {
+            auto [first, rest] = split(node->left, count);
+            return {first, makeNode(node->item, node->priority, rest, node->right)};
+        } else {
+            auto [first, rest] = split(node->right, count - leftSize - 1);
+            return {makeNode(node->item, node->priority, node->left, first), rest};
+        }
+    }
+
+    // Joins two treaps, all of first's entries before second's.
+    static NodePtr merge(const NodePtr &first, const NodePtr &second) {
+        if (first == nullptr) {
+            return second;
+        }
+        if (second == nullptr) {
+            return first;
+        }
+        if (first->priority > second->priority) {
+            return makeNode(first->item, first->priority, first->left, merge(first->right, second));
+        } else {
+            return makeNode(second->item, second->priority, merge(first, second->left), second->right);
+        }
+    }
+
+    static NodePtr replaceAt(const NodePtr &node, int index, const T &newEntry) {
+        int leftSize = sizeOf(node->left);
+        if (index < leftSize) {
+            return makeNode(node->item, node->priority, replaceAt(node->left, index, newEntry), node->right);
+        } else if (index > leftSize) {
+            return makeNode(node->item, node->priority, node->left, replaceAt(node->right, index - leftSize - 1, newEntry));
+        }
+        return makeNode(newEntry, node->priority, node->left, node->right);
+    }
+
+    const TreapNode *getNodeAt(int position) const {
+        const TreapNode *curPtr = rootPtr.get();
+        int index = position - 1;
+        while (true) {
+            int leftSize = sizeOf(curPtr->left);
+            if (index < leftSize) {
+                curPtr = curPtr->left.get();
+            } else if (index > leftSize) {
+                index -= leftSize + 1;
+                curPtr = curPtr->right.get();
+            } else {
+                return curPtr;
+            }
+        }
+    }
+
+public:
+    PersistentList() : rootPtr(nullptr), priorityGenerator(5489u) {}
+
+    // An O(1) copy that later changes to this list don't affect.
+    PersistentList snapshot() const {
+        return *this;
+    }
+
+    bool isEmpty() const {
+        return rootPtr == nullptr;
+    }
+
+    int getLength() const {
+        return sizeOf(rootPtr);
+    }
+
+    bool insert(int newPosition, const T &newEntry) {
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition <= getLength() + 1);
+        if (ableToInsert) {
+            auto [before, after] = split(rootPtr, newPosition - 1);
+            NodePtr newNodePtr = makeNode(newEntry, priorityGenerator(), nullptr, nullptr);
+            rootPtr = merge(merge(before, newNodePtr), after);
+        } // end if
+        return ableToInsert;
+    }
+
+    bool remove(int position) {
+        bool ableToRemove = (position >= 1) && (position <= getLength());
+        if (ableToRemove) {
+            auto [before, rest] = split(rootPtr, position - 1);
+            auto [removed, after] = split(rest, 1);
+            rootPtr = merge(before, after);
+        } // end if
+        return ableToRemove;
+    }
+
+    // Drops this version's reference; nodes still used by snapshots stay alive.
+    void clear() {
+        rootPtr = nullptr;
+    }
+
+    T getEntry(int position) const {
+        // Enforce precondition
+        bool ableToGet = (position >= 1) && (position <= getLength());
+        if (ableToGet) {
+            return getNodeAt(position)->item;
+        } else {
+            string message = "getEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    void replace(int position, const T &newEntry) {
+        // Enforce precondition
+        bool ableToSet = (position >= 1) && (position <= getLength());
+        if (ableToSet) {
+            rootPtr = replaceAt(rootPtr, position - 1, newEntry);
+        } else {
+            string message = "setEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+}; // end PersistentList
+
+TEST_CASE("test persistent implementation of list adt") {
+    PersistentList<int> list0;
+
+    testListADT(list0);
+
+    std::srand(39);
+    PersistentList<int> list1;
+    std::vector<int> expected;
+    std::vector<std::pair<PersistentList<int>, std::vector<int>>> versions;
+    for (int i = 0; i < 2000; i++) {
+        if (expected.empty() || std::rand() % 3 != 0) {
+            int position = std::rand() % (static_cast<int>(expected.size()) + 1) + 1;
+            CHECK(list1.insert(position, i));
+            expected.insert(expected.begin() + position - 1, i);
+        } else if (std::rand() % 2 == 0) {
+            int position = std::rand() % static_cast<int>(expected.size()) + 1;
+            CHECK(list1.remove(position));
+            expected.erase(expected.begin() + position - 1);
+        } else {
+            int position = std::rand() % static_cast<int>(expected.size()) + 1;
+            list1.replace(position, -i);
+            expected[position - 1] = -i;
+        }
+        if (i % 250 == 0) {
+            versions.emplace_back(list1.snapshot(), expected);
+        }
+    }
+    list1.clear();
+    CHECK(list1.isEmpty());
+
+    // Every snapshot still holds exactly what the list held when it was taken.
+    for (auto &[version, contents] : versions) {
+        REQUIRE(version.getLength() == static_cast<int>(contents.size()));
+        bool allMatch = true;
+        for (int i = 0; i < version.getLength(); i++) {
+            allMatch = allMatch && version.getEntry(i + 1) == contents[i];
+        }
+        CHECK(allMatch);
+    }
+
+    // Readers scan a snapshot on their own threads while the writer, thread 0, keeps changing the
+    // list it was taken from, so nodes shared with the snapshot are copied and dropped under them.
+    PersistentList<int> shared;
+    for (int i = 1; i <= 1000; i++) {
+        shared.insert(i, i);
+    }
+    PersistentList<int> published = shared.snapshot();
+    const int readers = 4;
+    const int passes = 20;
+    std::vector<long long> sums(readers + 1, 0);
+    runInParallel(readers + 1, [&](int thread) {
+        if (thread == 0) {
+            for (int pass = 0; pass < passes; pass++) {
+                for (int i = 1; i <= 1000; i++) {
+                    shared.replace(i, -pass);
+                }
+                shared.insert(1, pass);
+                shared.remove(shared.getLength());
+                PersistentList<int> dropped = shared.snapshot();
+            }
+            return;
+        }
+        for (int pass = 0; pass < passes; pass++) {
+            for (int i = 1; i <= published.getLength(); i++) {
+                sums[thread] += published.getEntry(i);
+            }
+        }
+    });
+    for (int reader = 1; reader <= readers; reader++) {
+        CHECK(sums[reader] == 500500LL * passes);
+    }
+    CHECK(shared.getLength() == 1000);
+    CHECK(shared.getEntry(1) == passes - 1);
+    CHECK(shared.getEntry(2) == -(passes - 1));
+}
+
+// ***** CONCURRENT ORDERED LIST *****
+
+// A sorted set of values that many threads can insert into, remove from and search at once.
+// Every node has its own mutex and a traversal locks hand over hand: it takes the next node's lock
+// before letting go of the current one, so two threads only wait on each other where their paths
+// overlap, instead of all of them waiting on one lock around the whole list. A node is unlinked
+// while both it and its predecessor are locked, and nobody can reach it without first locking the
+// predecessor, so it can be freed right away.
+template<typename T, typename Compare = std::less<T>>
+class ConcurrentOrderedList {
+private:
+    struct ItemNode;
+
+    // The part of a node that links to the next one; the head sentinel is only this.
+    struct Link {
+        mutable std::mutex lock;
+        std::unique_ptr<ItemNode> next;
+    };
+
+    struct ItemNode : Link {
+        T item;
+
+        explicit ItemNode(const T &item) : item(item) {}
+    };
+
+    Link head;
+    std::atomic<int> itemCount;
+    Compare comp;
+
+    // The lock on the link after which value belongs and, if there is one, the lock on the node
+    // holding the first item not less than value.
+    struct Window {
+        Link *predPtr;
+        ItemNode *curPtr;
+        std::unique_lock<std::mutex> predLock;
+        std::unique_lock<std::mutex> curLock;
+    };
+
+    Window findWindow(const T &value) const {
+        Window window{const_cast<Link *>(&head), nullptr, std::unique_lock<std::mutex>(head.lock), {}};
+        window.curPtr = window.predPtr->next.get();
+        while (window.curPtr != nullptr) {
+            window.curLock = std::unique_lock<std::mutex>(window.curPtr->lock);
+            if (!comp(window.curPtr->item, value)) {
+                break;
+            }
+            window.predPtr = window.curPtr;
+            window.predLock = std::move(window.curLock);
+            window.curPtr = window.curPtr->next.get();
+        }
+        return window;
+    }
+
+    bool holds(const Window &window, const T &value) const {
+        return window.curPtr != nullptr && !comp(value, window.curPtr->item);
+    }
+
+public:
+    ConcurrentOrderedList() : itemCount(0) {}
+
+    explicit ConcurrentOrderedList(Compare comp) : itemCount(0), comp(comp) {}
+
+    ConcurrentOrderedList(const ConcurrentOrderedList &) = delete;
+    ConcurrentOrderedList &operator=(const ConcurrentOrderedList &) = delete;
+
+    ~ConcurrentOrderedList() {
+        clear();
+    }
+
+    // Adds value unless an equal one is already there. Returns true if it was added.
+    bool insert(const T &value) {
+        Window window = findWindow(value);
+        if (holds(window, value)) {
+            return false;
+        }
+        auto newNodePtr = std::make_unique<ItemNode>(value);
+        newNodePtr->next = std::move(window.predPtr->next);
+        window.predPtr->next = std::move(newNodePtr);
+        ++itemCount;
+        return true;
+    }
+
+    // Removes the item equal to value. Returns true if there was one.
+    bool remove(const T &value) {
+        Window window = findWindow(value);
+        if (!holds(window, value)) {
+            return false;
+        }
+        std::unique_ptr<ItemNode> removedPtr = std::move(window.predPtr->next);
+        window.predPtr->next = std::move(removedPtr->next);
+        window.curLock.unlock();
+        --itemCount;
+        return true;
+    }
+
+    bool contains(const T &value) const {
+        Window window = findWindow(value);
+        return holds(window, value);
+    }
+
+    // The number of items, which may already be stale if other threads are changing the list.
+    int getLength() const {
+        return itemCount.load();
+    }
+
+    bool isEmpty() const {
+        return getLength() == 0;
+    }
+
+    // Copies the items in order. Each node is read under its lock, but other threads may change
+    // parts of the list this walk has already passed.
+    std::vector<T> toVector() const {
+        std::vector<T> items;
+        std::unique_lock<std::mutex> predLock(head.lock);
+        for (const ItemNode *curPtr = head.next.get(); curPtr != nullptr; curPtr = curPtr->next.get()) {
+            std::unique_lock<std::mutex> curLock(curPtr->lock);
+            items.push_back(curPtr->item);
+            predLock = std::move(curLock);
+        }
+        return items;
+    }
+
+    // Not safe to call while other threads use the list.
+    void clear() {
+        std::unique_ptr<ItemNode> curPtr = std::move(head.next);
+        while (curPtr != nullptr) {
+            curPtr = std::move(curPtr->next);
+        }
+        itemCount = 0;
+    }
+}; // end ConcurrentOrderedList
+
+TEST_CASE("test concurrent ordered list") {
+    ConcurrentOrderedList<int> list0;
+    CHECK(list0.isEmpty());
+    CHECK(list0.insert(5));
+    CHECK(list0.insert(1));
+    CHECK(list0.insert(3));
+    CHECK_FALSE(list0.insert(3));
+    CHECK(list0.contains(1));
+    CHECK_FALSE(list0.contains(2));
+    CHECK(list0.toVector() == std::vector<int>{1, 3, 5});
+    CHECK(list0.remove(1));
+    CHECK_FALSE(list0.remove(1));
+    CHECK(list0.remove(5));
+    CHECK(list0.toVector() == std::vector<int>{3});
+    CHECK(list0.getLength() == 1);
+
+    // Threads insert interleaved values, then remove the odd ones while others search.
+    const int threads = 4;
+    const int perThread = 500;
+    ConcurrentOrderedList<int, std::greater<int>> list1;
+    runInParallel(threads, [&](int t) {
+        for (int i = 0; i < perThread; i++) {
+            list1.insert(i * threads + t);
+        }
+    });
+    CHECK(list1.getLength() == threads * perThread);
+    std::vector<int> items = list1.toVector();
+    CHECK(std::is_sorted(items.begin(), items.end(), std::greater<int>()));
+
+    std::vector<int> evensFound(threads, 0);
+    runInParallel(threads, [&](int t) {
+        for (int i = 0; i < perThread; i++) {
+            int value = i * threads + t;
+            if (value % 2 == 1) {
+                list1.remove(value);
+            } else if (list1.contains(value)) {
+                evensFound[t]++;
+            }
+        }
+    });
+    CHECK(std::accumulate(evensFound.begin(), evensFound.end(), 0) == threads * perThread / 2);
+    items = list1.toVector();
+    CHECK(items.size() == threads * perThread / 2);
+    CHECK(std::all_of(items.begin(), items.end(), [](int value) { return value % 2 == 0; }));
+}
+
+TEST_CASE("benchmark concurrent ordered list" * doctest::skip()) {
+    const int keyRange = 1024;
+    const int totalOperations = 1 << 18;
+    const std::vector<int> readPercents = {100, 90, 50, 10};
+
+    // Runs a mix of contains, insert and remove on random keys, with updates split evenly between
+    // inserts and removes so the list stays about half full, and returns operations per second.
+    auto throughput = [&](int threads, int readPercent, auto operation) {
+        const int operationsPerThread = totalOperations / threads;
+        double seconds = secondsToRun([&]() {
+            runInParallel(threads, [&](int t) {
+                std::mt19937 generator(40 + t);
+                for (int i = 0; i < operationsPerThread; i++) {
+                    int key = static_cast<int>(generator() % keyRange);
+                    int kind = static_cast<int>(generator() % 100);
+                    operation(kind < readPercent ? 0 : (kind % 2 == 0 ? 1 : 2), key);
+                }
+            });
+        });
+        return threads * operationsPerThread / seconds;
+    };
+
+    for (int readPercent : readPercents) {
+        for (int threads = 1; threads <= 64; threads *= 2) {
+            // The baseline is a plain sorted chain with one mutex around every operation.
+            ConcurrentOrderedList<int> fineList;
+            std::list<int> coarseList;
+            std::mutex globalLock;
+            for (int key = 0; key < keyRange; key += 2) {
+                fineList.insert(key);
+                coarseList.push_back(key);
+            }
+            double fine = throughput(threads, readPercent, [&](int kind, int key) {
+                if (kind == 0) {
+                    fineList.contains(key);
+                } else if (kind == 1) {
+                    fineList.insert(key);
+                } else {
+                    fineList.remove(key);
+                }
+            });
+            double coarse = throughput(threads, readPercent, [&](int kind, int key) {
+                std::lock_guard<std::mutex> guard(globalLock);
+                auto position = std::find_if(coarseList.begin(), coarseList.end(),
+                                             [key](int value) { return !(value < key); });
+                bool found = position != coarseList.end() && *position == key;
+                if (kind == 1 && !found) {
+                    coarseList.insert(position, key);
+                } else if (kind == 2 && found) {
+                    coarseList.erase(position);
+                }
+            });
+            std::cout << readPercent << "% reads, " << threads << " threads: hand over hand "
+                      << fine << " ops/sec, one global mutex " << coarse << " ops/sec" << std::endl;
+        }
+    }
+}
+
+// ***** COLUMNAR LIST *****
+
+// Describes one data member of a record, e.g. Field<&Particle::mass>.
+template<auto MemberPtr>
+struct Field;
+
+template<typename Record, typename FieldType, FieldType Record::*MemberPtr>
+struct Field<MemberPtr> {
+    using RecordType = Record;
+    using Type = FieldType;
+
+    static const FieldType &of(const Record &record) {
+        return record.*MemberPtr;
+    }
+
+    static FieldType &of(Record &record) {
+        return record.*MemberPtr;
+    }
+};
+
+// A list of records stored as a struct of arrays: each described field gets its own contiguous
+// array, so a scan over one field only touches that field's memory and the loop over it can be
+// vectorized. getEntry rebuilds a record from a default constructed one, so members without a
+// Field are not kept.
+template<typename Record, typename... Fields>
+class ColumnarList final : public ListADT<Record> {
+private:
+    static_assert(sizeof...(Fields) > 0, "A columnar list needs at least one field.");
+    static_assert((std::is_same_v<typename Fields::RecordType, Record> && ...),
+                  "Every field must be a member of the record type.");
+
+    std::tuple<std::vector<typename Fields::Type>...> columns;
+    int itemCount;
+
+    template<auto MemberPtr>
+    static constexpr std::size_t indexOf() {
+        constexpr bool matches[] = {std::is_same_v<Fields, Field<MemberPtr>>...};
+        for (std::size_t i = 0; i < sizeof...(Fields); i++) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        return sizeof...(Fields);
+    }
+
+    template<typename Action>
+    void forEachColumn(Action action) {
+        forEachColumn(action, std::index_sequence_for<Fields...>());
+    }
+
+    template<typename Action, std::size_t... I>
+    void forEachColumn(Action &action, std::index_sequence<I...>) {
+        (action(std::get<I>(columns), Fields()), ...);
+    }
+
+public:
+    ColumnarList() : itemCount(0) {}
+
+    bool isEmpty() const {
+        return itemCount == 0;
+    }
+
+    int getLength() const {
+        return itemCount;
+    }
+
+    void reserve(int capacity) {
+        forEachColumn([capacity](auto &column, auto) { column.reserve(capacity); });
+    }
+
+    bool insert(int newPosition, const Record &newEntry) {
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition <= itemCount + 1);
+        if (ableToInsert) {
+            forEachColumn([&](auto &column, auto field) {
+                column.insert(column.begin() + (newPosition - 1), decltype(field)::of(newEntry));
+            });
+            itemCount++;
+        } // end if
+        return ableToInsert;
+    }
+
+    bool remove(int position) {
+        bool ableToRemove = (position >= 1) && (position <= itemCount);
+        if (ableToRemove) {
+            forEachColumn([position](auto &column, auto) { column.erase(column.begin() + (position - 1)); });
+            itemCount--;
+        } // end if
+        return ableToRemove;
+    }
+
+    void clear() {
+        forEachColumn([](auto &column, auto) { column.clear(); });
+        itemCount = 0;
+    }
+
+    Record getEntry(int position) const {
+        // Enforce precondition
+        bool ableToGet = (position >= 1) && (position <= itemCount);
+        if (ableToGet) {
+            Record entry{};
+            std::apply([&](const auto &... column) {
+                ((Fields::of(entry) = column[position - 1]), ...);
+            }, columns);
+            return entry;
+        } else {
+            string message = "getEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    void replace(int position, const Record &newEntry) {
+        // Enforce precondition
+        bool ableToSet = (position >= 1) && (position <= itemCount);
+        if (ableToSet) {
+            forEachColumn([&](auto &column, auto field) {
+                column[position - 1] = decltype(field)::of(newEntry);
+            });
+        } else {
+            string message = "setEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    // All values of one field in list order, e.g. list.column<&Particle::mass>().
+    template<auto MemberPtr>
+    const auto &column() const {
+        static_assert(indexOf<MemberPtr>() < sizeof...(Fields), "The member has no field in this list.");
+        return std::get<indexOf<MemberPtr>()>(columns);
+    }
+
+    // The values of one field as a writable array of getLength() entries, for updating a whole
+    // column in place. Inserting or removing entries invalidates it.
+    template<auto MemberPtr>
+    auto *columnData() {
+        static_assert(indexOf<MemberPtr>() < sizeof...(Fields), "The member has no field in this list.");
+        return std::get<indexOf<MemberPtr>()>(columns).data();
+    }
+}; // end ColumnarList
+
+struct Particle {
+    double x;
+    double y;
+    double velocityX;
+    double velocityY;
+    double mass;
+    int id;
+
+    bool operator==(const Particle &other) const {
+        return x == other.x && y == other.y && velocityX == other.velocityX &&
+               velocityY == other.velocityY && mass == other.mass && id == other.id;
+    }
+};
+
+using ParticleColumns = ColumnarList<Particle, Field<&Particle::x>, Field<&Particle::y>,
+        Field<&Particle::velocityX>, Field<&Particle::velocityY>, Field<&Particle::mass>, Field<&Particle::id>>;
+
+// Sums one field with a plain loop over its array.
+template<typename ValueType>
+ValueType sumColumn(const std::vector<ValueType> &column) {
+    ValueType total{};
+    for (const ValueType &value : column) {
+        total += value;
+    }
+    return total;
 }
 
-TEST_CASE("testing array insertion sort") {
-    ArrayList<int, MAX_ARRAY_SIZE> list0;
-    insertionSort(list0);
+TEST_CASE("test columnar implementation of list adt") {
+    ParticleColumns list0;
     CHECK(list0.isEmpty());
+    CHECK_THROWS(list0.getEntry(1));
+    CHECK_THROWS(list0.replace(1, Particle{}));
 
-    ArrayList<int, MAX_ARRAY_SIZE> list1;
-    CHECK(list1.insert(1, 10));
-    insertionSort(list1);
-    CHECK(list1.getLength() == 1);
+    std::vector<Particle> expected;
+    std::srand(41);
+    for (int i = 0; i < 300; i++) {
+        Particle particle{i * 1.0, i * 2.0, 0.5, -0.5, 1.0 + i % 7, i};
+        if (expected.empty() || std::rand() % 4 != 0) {
+            int position = std::rand() % (static_cast<int>(expected.size()) + 1) + 1;
+            CHECK(list0.insert(position, particle));
+            expected.insert(expected.begin() + position - 1, particle);
+        } else {
+            int position = std::rand() % static_cast<int>(expected.size()) + 1;
+            CHECK(list0.remove(position));
+            expected.erase(expected.begin() + position - 1);
+        }
+    }
+    CHECK_FALSE(list0.insert(0, Particle{}));
+    CHECK_FALSE(list0.remove(list0.getLength() + 1));
+    list0.replace(1, Particle{-1, -2, -3, -4, -5, -6});
+    expected[0] = Particle{-1, -2, -3, -4, -5, -6};
 
-    ArrayList<int, MAX_ARRAY_SIZE> list2;
-    CHECK(list2.insert(1, 10));
-    CHECK(list2.insert(1, 20));
-    insertionSort(list2);
-    CHECK(list2.getEntry(1) == 10);
-    CHECK(list2.getEntry(2) == 20);
+    REQUIRE(list0.getLength() == static_cast<int>(expected.size()));
+    bool allMatch = true;
+    for (int i = 0; i < list0.getLength(); i++) {
+        allMatch = allMatch && list0.getEntry(i + 1) == expected[i];
+    }
+    CHECK(allMatch);
 
-    ArrayList<int, MAX_ARRAY_SIZE> list3;
-    CHECK(list3.insert(1, 10));
-    CHECK(list3.insert(1, 20));
-    CHECK(list3.insert(1, 30));
+    // Column scans see the same values in list order.
+    const std::vector<int> &ids = list0.column<&Particle::id>();
+    REQUIRE(ids.size() == expected.size());
+    CHECK(std::equal(ids.begin(), ids.end(), expected.begin(),
+                     [](int id, const Particle &particle) { return id == particle.id; }));
+    double expectedMass = 0.0;
+    for (const Particle &particle : expected) {
+        expectedMass += particle.mass;
+    }
+    CHECK(sumColumn(list0.column<&Particle::mass>()) == expectedMass);
 
-    insertionSort(list3);
+    // Updating whole columns in place.
+    double *x = list0.columnData<&Particle::x>();
+    const double *velocityX = list0.column<&Particle::velocityX>().data();
+    for (int i = 0; i < list0.getLength(); i++) {
+        x[i] += velocityX[i];
+    }
+    CHECK(list0.getEntry(2).x == expected[1].x + expected[1].velocityX);
 
-    CHECK(list3.getEntry(1) == 10);
-    CHECK(list3.getEntry(2) == 20);
-    CHECK(list3.getEntry(3) == 30);
+    list0.clear();
+    CHECK(list0.isEmpty());
+    CHECK(list0.column<&Particle::y>().empty());
+}
 
-    ArrayList<int, MAX_ARRAY_SIZE> listRandom;
-    fillRandom(listRandom, 32);
-    insertionSort(listRandom);
-    CHECK(isSorted(listRandom));
+TEST_CASE("benchmark columnar list scan" * doctest::skip()) {
+    const int n = 4000000;
+    const int passes = 20;
+    ArrayList<Particle, MAX_ARRAY_SIZE> rows;
+    ParticleColumns columns;
+    rows.reserve(n);
+    columns.reserve(n);
+    for (int i = 0; i < n; i++) {
+        Particle particle{i * 1.0, i * 2.0, 0.5, -0.5, 1.0 + i % 7, i};
+        rows.insert(i + 1, particle);
+        columns.insert(i + 1, particle);
+    }
+
+    double rowTotal = 0.0;
+    double rowSeconds = secondsToRun([&]() {
+        for (int pass = 0; pass < passes; pass++) {
+            for (const Particle &particle : rows) {
+                rowTotal += particle.mass;
+            }
+        }
+    });
+    double columnTotal = 0.0;
+    double columnSeconds = secondsToRun([&]() {
+        for (int pass = 0; pass < passes; pass++) {
+            columnTotal += sumColumn(columns.column<&Particle::mass>());
+        }
+    });
+    CHECK(rowTotal == columnTotal);
+    std::cout << "Summing mass over " << n << " particles " << passes << " times: ArrayList "
+              << rowSeconds << " s, ColumnarList " << columnSeconds << " s" << std::endl;
+}
+
+// ***** MEMORY-MAPPED LIST *****
+
+// The start of a MappedArrayList file. Entries follow it in place, so opening a file only maps it
+// and checks this header, there is nothing to parse.
+struct MappedListHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t elementSize;
+    std::uint64_t count;
+    std::uint64_t capacity;
+    std::uint32_t endianTag; // written as 0x01020304, reads back differently on the other byte order
+};
+
+constexpr char MAPPED_LIST_MAGIC[8] = {'L', 'I', 'S', 'T', 'M', 'A', 'P', '\0'};
+constexpr std::uint32_t MAPPED_LIST_VERSION = 1;
+constexpr std::uint32_t MAPPED_LIST_ENDIAN_TAG = 0x01020304;
+constexpr std::size_t MAPPED_LIST_DATA_OFFSET = 64;
+
+static_assert(sizeof(MappedListHeader) <= MAPPED_LIST_DATA_OFFSET, "The header must fit before the entries.");
+
+// An ArrayList kept in a memory-mapped file, for trivially copyable entries. The entries are the
+// file's bytes, so the list survives the process and reopening it is instant. The file grows by
+// doubling its capacity and remapping. Changes reach the file through the page cache; sync
+// waits until they are on disk. Errors opening or growing the file throw std::runtime_error.
+template<typename T>
+class MappedArrayList final : public ListADT<T> {
+private:
+    static_assert(std::is_trivially_copyable_v<T>, "Mapped entries must be trivially copyable.");
+
+    int fileDescriptor;
+    void *mapping;
+    std::size_t mappedBytes;
+
+    static std::runtime_error systemError(const string &what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    // The most entries a file can hold: positions are ints, and the file's size must fit in off_t.
+    static constexpr std::uint64_t MAX_CAPACITY = std::min<std::uint64_t>(
+            std::numeric_limits<int>::max(),
+            (static_cast<std::uint64_t>(std::numeric_limits<off_t>::max()) - MAPPED_LIST_DATA_OFFSET) / sizeof(T));
+
+    // capacity must be at most MAX_CAPACITY.
+    static std::size_t bytesFor(std::uint64_t capacity) {
+        return MAPPED_LIST_DATA_OFFSET + capacity * sizeof(T);
+    }
+
+    MappedListHeader *header() const {
+        return static_cast<MappedListHeader *>(mapping);
+    }
+
+    T *items() const {
+        return reinterpret_cast<T *>(static_cast<char *>(mapping) + MAPPED_LIST_DATA_OFFSET);
+    }
+
+    // Maps the first bytes of the file, replacing any earlier mapping only once the new one is in
+    // place, so a failure leaves the list as it was.
+    void mapFile(std::size_t bytes) {
+        void *newMapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if (newMapping == MAP_FAILED) {
+            throw systemError("mmap failed");
+        }
+        unmapFile();
+        mapping = newMapping;
+        mappedBytes = bytes;
+    }
+
+    void unmapFile() {
+        if (mapping != nullptr) {
+            munmap(mapping, mappedBytes);
+            mapping = nullptr;
+        }
+    }
+
+    // Checks that an existing file was written by this class for entries like T.
+    void validateHeader(std::size_t fileBytes) const {
+        const MappedListHeader *h = header();
+        if (std::memcmp(h->magic, MAPPED_LIST_MAGIC, sizeof(MAPPED_LIST_MAGIC)) != 0) {
+            throw std::runtime_error("Not a mapped list file.");
+        }
+        if (h->endianTag != MAPPED_LIST_ENDIAN_TAG) {
+            throw std::runtime_error("Mapped list file was written with a different byte order.");
+        }
+        if (h->version != MAPPED_LIST_VERSION) {
+            throw std::runtime_error("Unsupported mapped list version " + std::to_string(h->version) + ".");
+        }
+        if (h->elementSize != sizeof(T)) {
+            throw std::runtime_error("Mapped list file holds entries of a different size.");
+        }
+        if (h->capacity > MAX_CAPACITY || h->count > h->capacity || bytesFor(h->capacity) > fileBytes) {
+            throw std::runtime_error("Mapped list file is truncated or corrupt.");
+        }
+    }
+
+    void ensureCapacity(std::uint64_t needed) {
+        std::uint64_t capacity = header()->capacity;
+        if (needed <= capacity) {
+            return;
+        }
+        if (needed > MAX_CAPACITY) {
+            throw std::length_error("Mapped list would be too large for its file.");
+        }
+        std::uint64_t newCapacity = std::max(needed, std::min(capacity * 2, MAX_CAPACITY));
+        if (ftruncate(fileDescriptor, static_cast<off_t>(bytesFor(newCapacity))) != 0) {
+            throw systemError("ftruncate failed");
+        }
+        // A larger file with the old capacity in its header is still valid if this fails.
+        mapFile(bytesFor(newCapacity));
+        header()->capacity = newCapacity;
+    }
+
+    void shiftItems(int fromIndex, int toIndex) {
+        std::memmove(items() + toIndex, items() + fromIndex, (getLength() - fromIndex) * sizeof(T));
+    }
+
+public:
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    // Opens the list stored at path, creating an empty one if the file doesn't exist.
+    explicit MappedArrayList(const string &path, int initialCapacity = MAX_ARRAY_SIZE)
+            : fileDescriptor(-1), mapping(nullptr), mappedBytes(0) {
+        fileDescriptor = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fileDescriptor < 0) {
+            throw systemError("Cannot open " + path);
+        }
+        try {
+            struct stat status{};
+            if (fstat(fileDescriptor, &status) != 0) {
+                throw systemError("fstat failed");
+            }
+            std::size_t fileBytes = static_cast<std::size_t>(status.st_size);
+            if (fileBytes == 0) {
+                std::uint64_t capacity = std::max(initialCapacity, 1);
+                if (ftruncate(fileDescriptor, static_cast<off_t>(bytesFor(capacity))) != 0) {
+                    throw systemError("ftruncate failed");
+                }
+                mapFile(bytesFor(capacity));
+                MappedListHeader *h = header();
+                std::memcpy(h->magic, MAPPED_LIST_MAGIC, sizeof(MAPPED_LIST_MAGIC));
+                h->version = MAPPED_LIST_VERSION;
+                h->elementSize = sizeof(T);
+                h->count = 0;
+                h->capacity = capacity;
+                h->endianTag = MAPPED_LIST_ENDIAN_TAG;
+            } else {
+                if (fileBytes < MAPPED_LIST_DATA_OFFSET) {
+                    throw std::runtime_error("Mapped list file is truncated or corrupt.");
+                }
+                mapFile(fileBytes);
+                validateHeader(fileBytes);
+            }
+        } catch (...) {
+            unmapFile();
+            close(fileDescriptor);
+            throw;
+        }
+    }
+
+    MappedArrayList(const MappedArrayList &) = delete;
+    MappedArrayList &operator=(const MappedArrayList &) = delete;
+
+    ~MappedArrayList() {
+        unmapFile();
+        if (fileDescriptor >= 0) {
+            close(fileDescriptor);
+        }
+    }
+
+    // Blocks until every change so far is on disk, a durability checkpoint.
+    void sync() {
+        if (msync(mapping, mappedBytes, MS_SYNC) != 0) {
+            throw systemError("msync failed");
+        }
+    }
+
+    bool isEmpty() const {
+        return getLength() == 0;
+    }
+
+    int getLength() const {
+        return static_cast<int>(header()->count);
+    }
+
+    int getCapacity() const {
+        return static_cast<int>(header()->capacity);
+    }
+
+    void reserve(int capacity) {
+        ensureCapacity(capacity);
+    }
+
+    bool insert(int newPosition, const T &newEntry) {
+        int itemCount = getLength();
+        bool ableToInsert = (newPosition >= 1) &&
+                            (newPosition - 1 <= itemCount);
+        if (ableToInsert) {
+            ensureCapacity(static_cast<std::uint64_t>(itemCount) + 1);
+            shiftItems(newPosition - 1, newPosition);
+            items()[newPosition - 1] = newEntry;
+            header()->count = itemCount + 1;
+        } // end if
+        return ableToInsert;
+    }
+
+    bool remove(int position) {
+        bool ableToRemove = (position >= 1) && (position <= getLength());
+        if (ableToRemove) {
+            shiftItems(position, position - 1);
+            header()->count--;
+        } // end if
+        return ableToRemove;
+    }
+
+    // Empties the list but keeps the file at its current size.
+    void clear() {
+        header()->count = 0;
+    }
+
+    T getEntry(int position) const {
+        // Enforce precondition
+        bool ableToGet = (position >= 1) && (position <= getLength());
+        if (ableToGet) {
+            return items()[position - 1];
+        } else {
+            string message = "getEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    void replace(int position, const T &newEntry) {
+        // Enforce precondition
+        bool ableToSet = (position >= 1) && (position <= getLength());
+        if (ableToSet) {
+            items()[position - 1] = newEntry;
+        } else {
+            string message = "setEntry() called with an empty list or ";
+            message = message + "invalid position.";
+            throw (std::invalid_argument(message));
+        }
+    }
+
+    // Pointers into the mapping; growing the list remaps it and invalidates them.
+    iterator begin() { return items(); }
+    iterator end() { return items() + getLength(); }
+    const_iterator begin() const { return items(); }
+    const_iterator end() const { return items() + getLength(); }
+}; // end MappedArrayList
+
+TEST_CASE("test memory-mapped implementation of list adt") {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("mapped_list_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+    std::string path = (directory / "list.bin").string();
+
+    {
+        MappedArrayList<int> list0(path);
+        testListADT(list0);
+    }
+    std::filesystem::remove(path);
+
+    {
+        MappedArrayList<int> list1(path, 4);
+        for (int i = 1; i <= 1000; i++) {
+            CHECK(list1.insert(i, i * 3));
+        }
+        CHECK(list1.getCapacity() >= 1000);
+        CHECK(list1.insert(1, -1));
+        CHECK(list1.remove(2));
+        list1.sync();
+    }
+
+    // Reopening sees the same entries without rebuilding anything.
+    {
+        MappedArrayList<int> list2(path);
+        REQUIRE(list2.getLength() == 1000);
+        CHECK(list2.getEntry(1) == -1);
+        CHECK(list2.getEntry(2) == 6);
+        CHECK(list2.getEntry(1000) == 3000);
+        CHECK(std::is_sorted(list2.begin() + 1, list2.end()));
+        list2.replace(1, 0);
+    }
+    {
+        MappedArrayList<int> list3(path);
+        CHECK(list3.getEntry(1) == 0);
+    }
+
+    // Files for other entry types or other formats are refused.
+    CHECK_THROWS_AS(MappedArrayList<double>{path}, std::runtime_error);
+    std::string otherPath = (directory / "other.bin").string();
+    {
+        std::FILE *file = std::fopen(otherPath.c_str(), "wb");
+        std::fputs("id,value\n1,2\n3,4\n5,6\n7,8\n9,10\n11,12\n13,14\n15,16\n17,18\n", file);
+        std::fclose(file);
+    }
+    CHECK_THROWS_AS(MappedArrayList<int>{otherPath}, std::runtime_error);
+
+    // So is a capacity whose size in bytes would wrap around to something that fits the file.
+    {
+        std::filesystem::copy_file(path, otherPath, std::filesystem::copy_options::overwrite_existing);
+        std::FILE *file = std::fopen(otherPath.c_str(), "r+b");
+        std::uint64_t hugeCapacity = std::uint64_t{1} << 62;
+        std::fseek(file, offsetof(MappedListHeader, capacity), SEEK_SET);
+        std::fwrite(&hugeCapacity, sizeof(hugeCapacity), 1, file);
+        std::fclose(file);
+    }
+    CHECK_THROWS_AS(MappedArrayList<int>{otherPath}, std::runtime_error);
+
+    // And one past the largest int position, even when the (sparse) file is big enough for it.
+    {
+        std::filesystem::remove(otherPath);
+        { MappedArrayList<char> bytes(otherPath); }
+        std::FILE *file = std::fopen(otherPath.c_str(), "r+b");
+        std::uint64_t pastIntCapacity = std::uint64_t{1} << 31;
+        std::fseek(file, offsetof(MappedListHeader, capacity), SEEK_SET);
+        std::fwrite(&pastIntCapacity, sizeof(pastIntCapacity), 1, file);
+        std::fclose(file);
+        std::filesystem::resize_file(otherPath, MAPPED_LIST_DATA_OFFSET + pastIntCapacity);
+    }
+    CHECK_THROWS_AS(MappedArrayList<char>{otherPath}, std::runtime_error);
+
+    std::filesystem::remove_all(directory);
+}
+
+// ***** BINARY SERIALIZATION *****
+
+// Every stream starts with an 8 byte header: a magic string, a format version, the writer's byte
+// order, the kind of container and a reserved byte. Values are written in the writer's own byte
+// order, so a reader on the same kind of machine copies them straight into place and only a reader
+// on the other kind swaps bytes.
+constexpr char SERIAL_MAGIC[4] = {'D', 'S', 'B', 'F'};
+constexpr std::uint8_t SERIAL_VERSION = 1;
+constexpr std::uint8_t SERIAL_LITTLE_ENDIAN = 1;
+constexpr std::uint8_t SERIAL_BIG_ENDIAN = 2;
+// Lengths and counts come from the data, so readers allocate for at most this many bytes ahead of
+// what they have actually read.
+constexpr std::size_t SERIAL_CHUNK_BYTES = 1 << 16;
+
+enum class SerialKind : std::uint8_t {
+    List = 1,
+    Stack = 2,
+    Tree = 3
+};
+
+inline std::uint8_t hostByteOrder() {
+    const std::uint16_t probe = 1;
+    std::uint8_t firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 1 ? SERIAL_LITTLE_ENDIAN : SERIAL_BIG_ENDIAN;
+}
+
+// The size recorded for an entry type so a reader can refuse data written for another type.
+// Strings are length prefixed and recorded as 0.
+template<class V>
+std::uint32_t serialElementSize() {
+    if constexpr (std::is_same_v<V, std::string>) {
+        return 0;
+    } else {
+        static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable entries and strings can be serialized.");
+        return sizeof(V);
+    }
+}
+
+// Streams values to out behind the header for one container.
+class BinaryWriter {
+private:
+    std::ostream &out;
+
+public:
+    BinaryWriter(std::ostream &out, SerialKind kind) : out(out) {
+        out.write(SERIAL_MAGIC, sizeof(SERIAL_MAGIC));
+        write(SERIAL_VERSION);
+        write(hostByteOrder());
+        write(static_cast<std::uint8_t>(kind));
+        write(std::uint8_t{0}); // reserved, pads the header to 8 bytes
+    }
+
+    template<class V>
+    void write(const V &value) {
+        static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable entries and strings can be serialized.");
+        out.write(reinterpret_cast<const char *>(&value), sizeof(V));
+    }
+
+    void write(const std::string &value) {
+        write<std::uint64_t>(value.size());
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    // Writes count values, as one block when they are trivially copyable.
+    template<class V>
+    void writeArray(const V *values, std::size_t count) {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(V)));
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                write(values[i]);
+            }
+        }
+    }
+
+    template<class V>
+    void writeElementSize() {
+        write(serialElementSize<V>());
+    }
+
+    void finish() {
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Writing serialized data failed.");
+        }
+    }
+};
+
+// Reads values back from in after checking the header. Data that is cut short, of another kind or
+// written for another entry type throws std::runtime_error.
+class BinaryReader {
+private:
+    std::istream &in;
+    bool swapBytes;
+
+    void readBytes(void *destination, std::size_t count) {
+        in.read(static_cast<char *>(destination), static_cast<std::streamsize>(count));
+        if (static_cast<std::size_t>(in.gcount()) != count) {
+            throw std::runtime_error("Serialized data ends early.");
+        }
+    }
+
+    template<class V>
+    static void swapByteOrder(V &value) {
+        if constexpr (std::is_arithmetic_v<V> || std::is_enum_v<V>) {
+            char *bytes = reinterpret_cast<char *>(&value);
+            std::reverse(bytes, bytes + sizeof(V));
+        } else if constexpr (sizeof(V) > 1) {
+            throw std::runtime_error("Cannot change the byte order of a compound entry.");
+        }
+    }
+
+public:
+    BinaryReader(std::istream &in, SerialKind kind) : in(in), swapBytes(false) {
+        char magic[sizeof(SERIAL_MAGIC)];
+        readBytes(magic, sizeof(magic));
+        if (std::memcmp(magic, SERIAL_MAGIC, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not serialized container data.");
+        }
+        if (read<std::uint8_t>() != SERIAL_VERSION) {
+            throw std::runtime_error("Unsupported serialization version.");
+        }
+        std::uint8_t byteOrder = read<std::uint8_t>();
+        if (byteOrder != SERIAL_LITTLE_ENDIAN && byteOrder != SERIAL_BIG_ENDIAN) {
+            throw std::runtime_error("Unknown byte order in serialized data.");
+        }
+        swapBytes = byteOrder != hostByteOrder();
+        if (read<std::uint8_t>() != static_cast<std::uint8_t>(kind)) {
+            throw std::runtime_error("Serialized data holds a different kind of container.");
+        }
+        read<std::uint8_t>();
+    }
+
+    template<class V>
+    V read() {
+        V value{};
+        readInto(value);
+        return value;
+    }
+
+    template<class V>
+    void readInto(V &value) {
+        readBytes(&value, sizeof(V));
+        if (swapBytes) {
+            swapByteOrder(value);
+        }
+    }
+
+    // Grows the string as its bytes arrive, so a corrupt length runs out of input instead of
+    // allocating memory up front.
+    void readInto(std::string &value) {
+        std::uint64_t length = read<std::uint64_t>();
+        if (length > value.max_size()) {
+            throw std::runtime_error("Serialized string is too long.");
+        }
+        value.clear();
+        while (value.size() < length) {
+            std::size_t start = value.size();
+            std::size_t step = static_cast<std::size_t>(std::min<std::uint64_t>(length - start, SERIAL_CHUNK_BYTES));
+            value.resize(start + step);
+            readBytes(&value[start], step);
+        }
+    }
+
+    // Reads count values straight into contiguous storage, as one block when they are trivially
+    // copyable.
+    template<class V>
+    void readArray(V *values, std::size_t count) {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            readBytes(values, count * sizeof(V));
+            if (swapBytes) {
+                for (std::size_t i = 0; i < count; i++) {
+                    swapByteOrder(values[i]);
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                readInto(values[i]);
+            }
+        }
+    }
+
+    template<class V>
+    void expectElementSize() {
+        if (read<std::uint32_t>() != serialElementSize<V>()) {
+            throw std::runtime_error("Serialized data holds a different entry type.");
+        }
+    }
+
+    // Reads an entry count and checks it fits in an int.
+    int readCount() {
+        std::uint64_t count = read<std::uint64_t>();
+        if (count > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("Serialized entry count is too large.");
+        }
+        return static_cast<int>(count);
+    }
+};
+
+// A list is written as its entry size, its length and then its entries in order. Both list
+// implementations use the same format, so either can load what the other saved.
+template<class ItemType, int N>
+void serialize(std::ostream &out, const ArrayList<ItemType, N> &list) {
+    BinaryWriter writer(out, SerialKind::List);
+    writer.writeElementSize<ItemType>();
+    writer.write<std::uint64_t>(list.getLength());
+    writer.writeArray(list.begin(), list.getLength());
+    writer.finish();
+}
+
+template<class ItemType>
+void serialize(std::ostream &out, const LinkedList<ItemType> &list) {
+    BinaryWriter writer(out, SerialKind::List);
+    writer.writeElementSize<ItemType>();
+    writer.write<std::uint64_t>(list.getLength());
+    for (const ItemType &entry : list) {
+        writer.write(entry);
+    }
+    writer.finish();
+}
+
+// Replaces the contents of list with the serialized entries, which are read in blocks straight
+// into the list's array. The array grows block by block, so a corrupt count fails at the end of
+// the data rather than allocating for entries that aren't there. The list is unchanged if reading
+// fails.
+template<class ItemType, int N>
+void deserialize(std::istream &in, ArrayList<ItemType, N> &list) {
+    BinaryReader reader(in, SerialKind::List);
+    reader.expectElementSize<ItemType>();
+    int count = reader.readCount();
+    const int blockLength = static_cast<int>(std::max<std::size_t>(1, SERIAL_CHUNK_BYTES / sizeof(ItemType)));
+    ArrayList<ItemType, N> loaded;
+    for (int done = 0; done < count;) {
+        int step = std::min(blockLength, count - done);
+        loaded.resize(done + step);
+        reader.readArray(loaded.begin() + done, step);
+        done += step;
+    }
+    list = std::move(loaded);
+}
+
+template<class ItemType>
+void deserialize(std::istream &in, LinkedList<ItemType> &list) {
+    BinaryReader reader(in, SerialKind::List);
+    reader.expectElementSize<ItemType>();
+    int count = reader.readCount();
+    list = LinkedList<ItemType>::fromGenerator(count, [&reader](int) { return reader.read<ItemType>(); });
+}
+
+TEST_CASE("test binary serialization of lists") {
+    ArrayList<int, MAX_ARRAY_SIZE> array0;
+    fillRandom(array0, 5000, 43);
+    std::stringstream arrayStream;
+    serialize(arrayStream, array0);
+    CHECK(arrayStream.str().size() == 8 + 4 + 8 + 5000 * sizeof(int));
+
+    ArrayList<int, MAX_ARRAY_SIZE> array1;
+    array1.insert(1, 7);
+    deserialize(arrayStream, array1);
+    CHECK(std::equal(array0.begin(), array0.end(), array1.begin(), array1.end()));
+
+    // Lists load into either implementation.
+    arrayStream.clear();
+    arrayStream.seekg(0);
+    LinkedList<int> list0;
+    deserialize(arrayStream, list0);
+    CHECK(std::equal(array0.begin(), array0.end(), list0.begin(), list0.end()));
+
+    LinkedList<std::string> words;
+    words.insert(1, "alpha");
+    words.insert(2, "");
+    words.insert(3, "gamma delta");
+    std::stringstream wordStream;
+    serialize(wordStream, words);
+    ArrayList<std::string, MAX_ARRAY_SIZE> loadedWords;
+    deserialize(wordStream, loadedWords);
+    CHECK(std::equal(words.begin(), words.end(), loadedWords.begin(), loadedWords.end()));
+
+    LinkedList<int> empty;
+    std::stringstream emptyStream;
+    serialize(emptyStream, empty);
+    deserialize(emptyStream, list0);
+    CHECK(list0.isEmpty());
+
+    // Bytes written on a machine with the other byte order are swapped on the way in.
+    std::string swapped = arrayStream.str();
+    swapped[5] = static_cast<char>(hostByteOrder() == SERIAL_LITTLE_ENDIAN ? SERIAL_BIG_ENDIAN : SERIAL_LITTLE_ENDIAN);
+    std::reverse(swapped.begin() + 8, swapped.begin() + 12);
+    std::reverse(swapped.begin() + 12, swapped.begin() + 20);
+    for (std::size_t i = 20; i < swapped.size(); i += sizeof(int)) {
+        std::reverse(swapped.begin() + i, swapped.begin() + i + sizeof(int));
+    }
+    std::stringstream swappedStream(swapped);
+    deserialize(swappedStream, array1);
+    CHECK(std::equal(array0.begin(), array0.end(), array1.begin(), array1.end()));
+
+    // Bad input throws and leaves the list alone.
+    std::stringstream truncated(arrayStream.str().substr(0, 100));
+    CHECK_THROWS_AS(deserialize(truncated, array1), std::runtime_error);
+    CHECK(array1.getLength() == 5000);
+    std::stringstream wrongType(arrayStream.str());
+    ArrayList<double, MAX_ARRAY_SIZE> doubles;
+    CHECK_THROWS_AS(deserialize(wrongType, doubles), std::runtime_error);
+    std::stringstream notSerialized("id,value\n1,2\n");
+    CHECK_THROWS_AS(deserialize(notSerialized, list0), std::runtime_error);
+
+    // Corrupt lengths run out of data instead of allocating for them.
+    std::string hugeCount = arrayStream.str().substr(0, 200);
+    std::uint64_t maxCount = std::numeric_limits<int>::max();
+    std::memcpy(&hugeCount[12], &maxCount, sizeof(maxCount));
+    std::stringstream hugeCountStream(hugeCount);
+    CHECK_THROWS_AS(deserialize(hugeCountStream, array1), std::runtime_error);
+    CHECK(array1.getLength() == 5000);
+    std::string hugeString = wordStream.str();
+    std::uint64_t hugeLength = std::uint64_t{1} << 62;
+    std::memcpy(&hugeString[20], &hugeLength, sizeof(hugeLength));
+    std::stringstream hugeStringStream(hugeString);
+    CHECK_THROWS_AS(deserialize(hugeStringStream, loadedWords), std::runtime_error);
+    CHECK(loadedWords.getLength() == 3);
 }
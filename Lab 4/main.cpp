@@ -10,11 +10,36 @@
 #include <cassert>
 #include <algorithm>
 #include <optional>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <functional>
+#include <fstream>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <numbers>
+#include <set>
+#include <map>
+
+// https://github.com/doctest/doctest/blob/master/doc/markdown/tutorial.md
+// The simulation has a main of its own, so the tests run when it is passed --test.
+#define DOCTEST_CONFIG_IMPLEMENT
+#include "doctest.h"
 
 using namespace std;
 
 const size_t MIN_TELLERS = 1;
-const size_t MAX_TELLERS = 5;
+// Customers of priority 1 and up are VIPs; a higher priority is served first.
+const int MAX_PRIORITY = 9;
 
 // Integer time units.
 using Time = int;
@@ -22,10 +47,14 @@ using Time = int;
 // We will be tracking teller state in a variable std::vector.
 using TellerIndex = size_t;
 
-// Arrival event containing only the arrival and transaction times.
+// Arrival event with the arrival and transaction times and, optionally, the customer's priority
+// class and how long they will wait in line before giving up. Plain {arrival, transaction} pairs
+// are regular customers who never give up.
 struct ArrivalEvent {
     Time arrivalTime;
     Time transactionTime;
+    int priority = 0;
+    Time patience = numeric_limits<Time>::max();
 };
 
 // This is a common idiom in FP, wrapping a type in another to yield better
@@ -43,22 +72,59 @@ struct DepartureEvent {
     TellerIndex tellerIndex;
 };
 
-// Either an arrival or departure event. Variant can be thought of as a safer union.
-using Event = std::variant<ArrivalEvent, DepartureEvent>;
+// A waiting customer's patience running out. line and place say where they stand and ticket
+// tells them apart from a later customer in the same place, in case they were served first.
+struct RenegeEvent {
+    Time renegeTime;
+    uint32_t line;
+    uint32_t place;
+    uint64_t ticket;
+};
+
+// An arrival, departure or renege event. Variant can be thought of as a safer union.
+using Event = std::variant<ArrivalEvent, DepartureEvent, RenegeEvent>;
 
-// Helper function to get the time from either an arrival or departure event.
+// Helper function to get the time from any event.
 Time get_event_time(const Event& e) {
     if(holds_alternative<ArrivalEvent>(e)) {
         return get<ArrivalEvent>(e).arrivalTime;
     }
+    if(holds_alternative<RenegeEvent>(e)) {
+        return get<RenegeEvent>(e).renegeTime;
+    }
     return get<DepartureEvent>(e).departureTime;
 }
 
 // A compare functor / function object for the priority queue. Creates a min-heap.
 struct CompareEvent {
-    bool operator()(const Event & e1, const Event & e2) {
+    bool operator()(const Event & e1, const Event & e2) const {
         // TODO: Create a min heap by replacing true with a boolean expression. Hint: Consult std::priority_queue.
-        return get_event_time(e1) > get_event_time(e2);
+        Time t1 = get_event_time(e1);
+        Time t2 = get_event_time(e2);
+        if (t1 != t2) {
+            return t1 > t2;
+        }
+        // At the same time departures come first, so their tellers are free for the arrival and
+        // can still serve a customer whose patience runs out then, and lower numbered tellers take
+        // the next customer in line first. Reneges come next, oldest ticket first, then arrivals.
+        if (e1.index() != e2.index()) {
+            return eventRank(e1) > eventRank(e2);
+        }
+        if (holds_alternative<DepartureEvent>(e1)) {
+            return get<DepartureEvent>(e1).tellerIndex > get<DepartureEvent>(e2).tellerIndex;
+        }
+        if (holds_alternative<RenegeEvent>(e1)) {
+            return get<RenegeEvent>(e1).ticket > get<RenegeEvent>(e2).ticket;
+        }
+        return false;
+    }
+
+    // The order of the kinds of events that happen at the same time.
+    static int eventRank(const Event & e) {
+        if (holds_alternative<DepartureEvent>(e)) {
+            return 0;
+        }
+        return holds_alternative<RenegeEvent>(e) ? 1 : 2;
     }
 };
 
@@ -108,8 +174,427 @@ public:
     }
 };
 
+// The indices of the tellers who are free, as a hierarchy of bitsets: one bit per teller, then one
+// bit per 64-bit word of the level below saying whether it has any bit set. Finding the lowest free
+// teller walks down from the single top word with countr_zero, and marking a teller free or busy
+// updates one word per level, so both are O(log64 T): three words for 10,000 tellers.
+class FreeTellerSet {
+private:
+    // levels[0] has a bit per teller, each later level a bit per word of the one before.
+    vector<vector<uint64_t>> levels;
+
+public:
+    // Starts with every teller free.
+    explicit FreeTellerSet(size_t tellerCount = 0) {
+        size_t bitCount = tellerCount;
+        do {
+            size_t wordCount = (bitCount + 63) / 64;
+            vector<uint64_t> words(wordCount, ~uint64_t{0});
+            if (bitCount % 64 != 0) {
+                words.back() = (uint64_t{1} << (bitCount % 64)) - 1;
+            }
+            levels.push_back(std::move(words));
+            bitCount = wordCount;
+        } while (bitCount > 1);
+    }
+
+    bool empty() const {
+        return levels.back()[0] == 0;
+    }
+
+    // The lowest free index. The set must not be empty.
+    TellerIndex lowest() const {
+        assert(!empty());
+        size_t index = 0;
+        for (size_t level = levels.size(); level-- > 0;) {
+            index = index * 64 + countr_zero(levels[level][index]);
+        }
+        return index;
+    }
+
+    void markFree(TellerIndex tellerIndex) {
+        size_t index = tellerIndex;
+        for (vector<uint64_t> & words : levels) {
+            bool wasEmpty = words[index / 64] == 0;
+            words[index / 64] |= uint64_t{1} << (index % 64);
+            if (!wasEmpty) {
+                break;
+            }
+            index /= 64;
+        }
+    }
+
+    void markBusy(TellerIndex tellerIndex) {
+        size_t index = tellerIndex;
+        for (vector<uint64_t> & words : levels) {
+            words[index / 64] &= ~(uint64_t{1} << (index % 64));
+            if (words[index / 64] != 0) {
+                break;
+            }
+            index /= 64;
+        }
+    }
+};
+
+TEST_CASE("testing the free teller set against a linear scan") {
+    mt19937 generator(45);
+    for (size_t tellerCount : {size_t{1}, size_t{63}, size_t{64}, size_t{65}, size_t{4097}}) {
+        FreeTellerSet freeTellers(tellerCount);
+        vector<bool> isFree(tellerCount, true);
+        bool allMatch = true;
+        for (int step = 0; step < 20000; ++step) {
+            TellerIndex tellerIndex = generator() % tellerCount;
+            if (generator() % 2 == 0) {
+                freeTellers.markBusy(tellerIndex);
+                isFree[tellerIndex] = false;
+            } else {
+                freeTellers.markFree(tellerIndex);
+                isFree[tellerIndex] = true;
+            }
+            auto lowest = find(isFree.begin(), isFree.end(), true);
+            allMatch = allMatch && freeTellers.empty() == (lowest == isFree.end());
+            if (!freeTellers.empty()) {
+                allMatch = allMatch && freeTellers.lowest() == static_cast<TellerIndex>(lowest - isFree.begin());
+            }
+        }
+        CHECK(allMatch);
+    }
+}
+
+// A binary min-heap that hands out a handle for each value it holds, so any value, not just the
+// smallest, can be removed or given a new key in O(log n). Handles of removed values are reused.
+template<class Key, class Value>
+class IndexedHeap {
+private:
+    static constexpr size_t NOT_HELD = numeric_limits<size_t>::max();
+
+    struct Entry {
+        Key key;
+        Value value;
+        size_t position; // in heap, or NOT_HELD
+    };
+
+    vector<Entry> entries; // by handle
+    vector<size_t> heap; // handles, smallest key first
+    vector<size_t> freeHandles;
+
+    void put(size_t position, size_t handle) {
+        heap[position] = handle;
+        entries[handle].position = position;
+    }
+
+    void siftUp(size_t position) {
+        size_t handle = heap[position];
+        while (position > 0) {
+            size_t parent = (position - 1) / 2;
+            if (!(entries[handle].key < entries[heap[parent]].key)) {
+                break;
+            }
+            put(position, heap[parent]);
+            position = parent;
+        }
+        put(position, handle);
+    }
+
+    void siftDown(size_t position) {
+        size_t handle = heap[position];
+        while (true) {
+            size_t child = 2 * position + 1;
+            if (child >= heap.size()) {
+                break;
+            }
+            if (child + 1 < heap.size() && entries[heap[child + 1]].key < entries[heap[child]].key) {
+                ++child;
+            }
+            if (!(entries[heap[child]].key < entries[handle].key)) {
+                break;
+            }
+            put(position, heap[child]);
+            position = child;
+        }
+        put(position, handle);
+    }
+
+public:
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    // Whether handle still refers to a value in the heap.
+    bool contains(size_t handle) const {
+        return handle < entries.size() && entries[handle].position != NOT_HELD;
+    }
+
+    const Key & keyOf(size_t handle) const {
+        assert(contains(handle));
+        return entries[handle].key;
+    }
+
+    // The handle of the value with the smallest key.
+    size_t top() const {
+        assert(!empty());
+        return heap[0];
+    }
+
+    size_t push(Key key, Value value) {
+        size_t handle;
+        if (freeHandles.empty()) {
+            handle = entries.size();
+            entries.push_back(Entry{std::move(key), std::move(value), NOT_HELD});
+        } else {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+            entries[handle].key = std::move(key);
+            entries[handle].value = std::move(value);
+        }
+        heap.push_back(handle);
+        siftUp(heap.size() - 1);
+        return handle;
+    }
+
+    // Takes out the value for handle, wherever it is in the heap.
+    Value erase(size_t handle) {
+        assert(contains(handle));
+        size_t position = entries[handle].position;
+        size_t last = heap.back();
+        heap.pop_back();
+        if (last != handle) {
+            put(position, last);
+            siftDown(position);
+            siftUp(entries[last].position);
+        }
+        entries[handle].position = NOT_HELD;
+        freeHandles.push_back(handle);
+        return std::move(entries[handle].value);
+    }
+
+    Value pop() {
+        return erase(top());
+    }
+
+    void updateKey(size_t handle, Key key) {
+        assert(contains(handle));
+        entries[handle].key = std::move(key);
+        siftDown(entries[handle].position);
+        siftUp(entries[handle].position);
+    }
+
+    void clear() {
+        entries.clear();
+        heap.clear();
+        freeHandles.clear();
+    }
+};
+
+TEST_CASE("testing the indexed heap against a sorted set") {
+    mt19937 generator(50);
+    IndexedHeap<pair<int, int>, int> heap;
+    set<pair<int, int>> expected;
+    map<int, size_t> handles;
+    int nextValue = 0;
+    bool allMatch = true;
+    for (int step = 0; step < 50000; ++step) {
+        int operation = generator() % 4;
+        if (operation < 2 || expected.empty()) {
+            pair<int, int> key{static_cast<int>(generator() % 100), nextValue};
+            handles[nextValue] = heap.push(key, nextValue);
+            expected.insert(key);
+            ++nextValue;
+        } else {
+            auto chosen = operation == 2 ? next(expected.begin(), generator() % expected.size()) : expected.begin();
+            size_t handle = operation == 2 ? handles[chosen->second] : heap.top();
+            allMatch = allMatch && heap.keyOf(handle) == *chosen;
+            int value = heap.erase(handle);
+            allMatch = allMatch && value == chosen->second && !heap.contains(handle);
+            handles.erase(value);
+            expected.erase(chosen);
+        }
+        if (!expected.empty() && generator() % 5 == 0) {
+            auto chosen = next(expected.begin(), generator() % expected.size());
+            pair<int, int> key{static_cast<int>(generator() % 100), chosen->second};
+            heap.updateKey(handles[chosen->second], key);
+            expected.erase(chosen);
+            expected.insert(key);
+        }
+        allMatch = allMatch && heap.size() == expected.size();
+        if (!expected.empty()) {
+            allMatch = allMatch && heap.keyOf(heap.top()) == *expected.begin();
+        }
+    }
+    CHECK(allMatch);
+}
+
+// A histogram of non-negative values in fixed memory, in the style of HdrHistogram. Values below
+// 256 get a bucket each. Above that, each power of two is split into 128 buckets, so any value is
+// off by less than 1% of itself. Percentiles come from the bucket counts, so no sample is kept.
+class LogHistogram {
+private:
+    static constexpr int SUB_BITS = 8;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BITS;
+    static constexpr uint64_t HALF_BUCKETS = SUB_BUCKETS / 2;
+    // Values from 2^MAX_BITS up share the last bucket; min and max stay exact.
+    static constexpr int MAX_BITS = 48;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (MAX_BITS - SUB_BITS) * HALF_BUCKETS;
+
+    vector<uint64_t> counts;
+    uint64_t total;
+    double sum;
+    uint64_t minValue;
+    uint64_t maxValue;
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        int shift = bit_width(value) - SUB_BITS;
+        if (shift > MAX_BITS - SUB_BITS) {
+            return BUCKET_COUNT - 1;
+        }
+        uint64_t mantissa = value >> shift; // between HALF_BUCKETS and SUB_BUCKETS - 1
+        return SUB_BUCKETS + (shift - 1) * HALF_BUCKETS + (mantissa - HALF_BUCKETS);
+    }
+
+    // The largest value that lands in a bucket.
+    static uint64_t highestIn(size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        uint64_t shift = (bucket - SUB_BUCKETS) / HALF_BUCKETS + 1;
+        uint64_t mantissa = (bucket - SUB_BUCKETS) % HALF_BUCKETS + HALF_BUCKETS;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+public:
+    LogHistogram() : counts(BUCKET_COUNT, 0), total(0), sum(0.0), minValue(0), maxValue(0) {}
+
+    // Records value count times, e.g. a queue length weighted by how long it lasted.
+    void record(long long value, uint64_t count = 1) {
+        if (value < 0) {
+            throw invalid_argument("LogHistogram values must not be negative.");
+        }
+        if (count == 0) {
+            return;
+        }
+        uint64_t v = static_cast<uint64_t>(value);
+        minValue = total == 0 ? v : std::min(minValue, v);
+        maxValue = total == 0 ? v : std::max(maxValue, v);
+        counts[bucketOf(v)] += count;
+        total += count;
+        sum += static_cast<double>(v) * static_cast<double>(count);
+    }
+
+    void merge(const LogHistogram & other) {
+        if (other.total == 0) {
+            return;
+        }
+        minValue = total == 0 ? other.minValue : std::min(minValue, other.minValue);
+        maxValue = total == 0 ? other.maxValue : std::max(maxValue, other.maxValue);
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    double mean() const {
+        return total == 0 ? 0.0 : sum / static_cast<double>(total);
+    }
+
+    uint64_t min() const {
+        return minValue;
+    }
+
+    uint64_t max() const {
+        return maxValue;
+    }
+
+    // The smallest recorded value that at least percent% of the recordings are at or below, to
+    // within the bucket width.
+    uint64_t percentile(double percent) const {
+        if (total == 0) {
+            return 0;
+        }
+        double wanted = ceil(clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(total));
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(wanted));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return clamp(highestIn(i), minValue, maxValue);
+            }
+        }
+        return maxValue;
+    }
+};
+
+TEST_CASE("testing log histogram percentiles against exact values") {
+    mt19937_64 generator(48);
+    lognormal_distribution<double> spread(8.0, 2.5);
+    vector<long long> values;
+    LogHistogram histogram;
+    LogHistogram even;
+    LogHistogram odd;
+    for (int i = 0; i < 100000; ++i) {
+        long long value = static_cast<long long>(spread(generator));
+        values.push_back(value);
+        histogram.record(value);
+        (i % 2 == 0 ? even : odd).record(value);
+    }
+    even.merge(odd);
+    sort(values.begin(), values.end());
+
+    CHECK(histogram.count() == values.size());
+    CHECK(histogram.min() == static_cast<uint64_t>(values.front()));
+    CHECK(histogram.max() == static_cast<uint64_t>(values.back()));
+    for (double percent : {0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+        size_t rank = max<size_t>(1, static_cast<size_t>(ceil(percent / 100.0 * values.size())));
+        double exact = static_cast<double>(values[rank - 1]);
+        double estimate = static_cast<double>(histogram.percentile(percent));
+        CHECK(estimate >= exact);
+        CHECK(estimate <= exact * 1.01 + 1);
+        CHECK(even.percentile(percent) == histogram.percentile(percent));
+    }
+
+    // Small values are exact, and counts weight a value.
+    LogHistogram weighted;
+    weighted.record(3, 10);
+    weighted.record(100);
+    CHECK(weighted.percentile(90) == 3);
+    CHECK(weighted.percentile(95) == 100);
+    CHECK(weighted.mean() == doctest::Approx(130.0 / 11));
+    CHECK_THROWS_AS(weighted.record(-1), invalid_argument);
+    CHECK(LogHistogram().percentile(50) == 0);
+}
+
+// What customers and tellers went through during one run.
+struct SimulationMetrics {
+    // From arrival until a teller starts the transaction.
+    LogHistogram waitTimes;
+    // From arrival until the transaction is done.
+    LogHistogram sojournTimes;
+    // The length of the bank line, weighted by how many time units it stayed that long.
+    LogHistogram queueLengths;
+    // The first arrival and the last departure.
+    Time startTime = 0;
+    Time endTime = 0;
+    // Wait times again, split by the customers' priority.
+    vector<LogHistogram> waitTimesByPriority;
+    // Customers who left because the line was too long, and who gave up waiting in it.
+    size_t customersBalked = 0;
+    size_t customersReneged = 0;
+};
+
 struct SimulationResults {
     vector<Time> elapsedTimeBusy;
+    SimulationMetrics metrics;
 
     // Finds the max teller time and is perhaps proportional to the customer wait time.
     Time maxTellerBusyTime() {
@@ -119,27 +604,403 @@ struct SimulationResults {
         return *max_element(elapsedTimeBusy.begin(), elapsedTimeBusy.end());
     }
 
-    SimulationResults(vector<Time> elapsedTimeBusy) : elapsedTimeBusy(elapsedTimeBusy) { }
+    // Every customer is served to the end, so this is the sum of the transaction times.
+    Time totalTellerBusyTime() {
+        Time total = 0;
+        for (Time busyTime : elapsedTimeBusy) {
+            total += busyTime;
+        }
+        return total;
+    }
+
+    // The share of the run, from the first arrival to the last departure, the tellers spent busy.
+    double utilization() {
+        Time runTime = metrics.endTime - metrics.startTime;
+        if (runTime <= 0 || elapsedTimeBusy.empty()) {
+            return 0.0;
+        }
+        return static_cast<double>(totalTellerBusyTime()) / (static_cast<double>(runTime) * elapsedTimeBusy.size());
+    }
+
+    // The bank line's length averaged over time.
+    double meanQueueLength() {
+        return metrics.queueLengths.mean();
+    }
+
+    SimulationResults(vector<Time> elapsedTimeBusy, SimulationMetrics metrics = SimulationMetrics())
+            : elapsedTimeBusy(std::move(elapsedTimeBusy)), metrics(std::move(metrics)) { }
+};
+
+// Where a customer stands in line: ahead of everyone of a lower priority, then in ticket order,
+// which is the order they joined in.
+struct PlaceInLine {
+    int priority;
+    uint64_t ticket;
+
+    bool operator<(const PlaceInLine & other) const {
+        if (priority != other.priority) {
+            return priority > other.priority;
+        }
+        return ticket < other.ticket;
+    }
+};
+
+// A line of customers waiting to be served by a teller, VIPs first and otherwise first come, first
+// served. A customer who gives up can leave from anywhere in it in O(log n).
+using BankLine = IndexedHeap<PlaceInLine, Customer>;
+
+// How customers line up.
+struct ServiceDiscipline {
+    // One line per teller instead of one for the whole bank. A customer who finds every teller
+    // busy joins the shortest line, the lowest numbered on a tie, and stays in it.
+    bool linePerTeller = false;
+    // A customer who finds this many waiting in the line they would join leaves right away.
+    size_t balkingLength = numeric_limits<size_t>::max();
+};
+// The default event queue: a binary heap, O(log n) per push and pop.
+using HeapEventQueue = priority_queue<Event, vector<Event>, CompareEvent>;
+
+// A hierarchical timing wheel. Since Time is an integer, an event's key (its time with two low bits
+// that put departures before reneges before arrivals) can be split into base-256 digits. Each of the five levels
+// has one slot per digit value, and an event sits on the level of the highest digit where its key
+// differs from the current key, in the slot for its own digit there. Everything on level 0 then
+// shares the current key's upper digits, so its slot gives the exact key, and finding the earliest
+// event is a bitmap scan. When level 0 runs dry, the first slot of the lowest occupied level is
+// spread over the levels below it. An event moves down at most four times, so push and pop are
+// O(1) amortized and no two events are compared.
+//
+// Events can't be scheduled before the time of the earliest one already taken out, which holds
+// for a simulation that only schedules into the present or future. An event at the current key,
+// or at the current time with a kind that goes earlier, like the departure of a zero-length
+// transaction, joins the slot being drained in CompareEvent order. Events at the same time come out in the same
+// order as from the heap: a slot is sorted with CompareEvent when it starts to drain.
+class TimingWheelEventQueue {
+private:
+    using Key = uint64_t;
+
+    static constexpr int KEY_BITS = 34;
+    static constexpr int DIGIT_BITS = 8;
+    static constexpr int SLOTS = 1 << DIGIT_BITS;
+    static constexpr int LEVELS = (KEY_BITS + DIGIT_BITS - 1) / DIGIT_BITS;
+    static constexpr int WORDS = SLOTS / 64;
+
+    array<array<vector<Event>, SLOTS>, LEVELS> slots;
+    array<array<uint64_t, WORDS>, LEVELS> occupied;
+    // No event is earlier than this. Level 0's slot for it is the one being drained.
+    Key current;
+    // Events already taken from the front of the slot being drained.
+    size_t drained;
+    // Whether the slot being drained has been put in CompareEvent order.
+    bool drainingSorted;
+    size_t eventCount;
+
+    // Orders negative times before positive ones by flipping the sign bit, then by the kind of
+    // event as CompareEvent does.
+    static Key keyOf(const Event & e) {
+        Key time = static_cast<uint32_t>(get_event_time(e)) ^ (uint32_t{1} << 31);
+        return time << 2 | static_cast<Key>(CompareEvent::eventRank(e));
+    }
+
+    static int digitOf(Key key, int level) {
+        return static_cast<int>((key >> (level * DIGIT_BITS)) & (SLOTS - 1));
+    }
+
+    void place(Event e, Key key) {
+        Key differentBits = key ^ current;
+        int level = differentBits == 0 ? 0 : (bit_width(differentBits) - 1) / DIGIT_BITS;
+        int slot = digitOf(key, level);
+        slots[level][slot].push_back(std::move(e));
+        occupied[level][slot / 64] |= uint64_t{1} << (slot % 64);
+    }
+
+    // Returns the first occupied slot on a level or -1 if it is empty.
+    int firstOccupied(int level) const {
+        for (int word = 0; word < WORDS; ++word) {
+            if (occupied[level][word] != 0) {
+                return word * 64 + countr_zero(occupied[level][word]);
+            }
+        }
+        return -1;
+    }
+
+    // Moves current up to the earliest event so it is at the front of its level 0 slot.
+    void settle() {
+        int slot = firstOccupied(0);
+        if (slot < 0) {
+            int level = 1;
+            while (firstOccupied(level) < 0) {
+                ++level;
+            }
+            int cascadeSlot = firstOccupied(level);
+            vector<Event> cascading = std::move(slots[level][cascadeSlot]);
+            slots[level][cascadeSlot].clear();
+            occupied[level][cascadeSlot / 64] &= ~(uint64_t{1} << (cascadeSlot % 64));
+
+            current = keyOf(cascading.front());
+            for (const Event & e : cascading) {
+                current = min(current, keyOf(e));
+            }
+            for (Event & e : cascading) {
+                Key key = keyOf(e);
+                place(std::move(e), key);
+            }
+            slot = firstOccupied(0);
+        }
+        current = (current & ~Key{SLOTS - 1}) | static_cast<Key>(slot);
+
+        if (!drainingSorted) {
+            // One slot holds a single key, so its events are all of one kind and at one time.
+            // Arrivals compare equal and keep the order they were pushed in.
+            if (slots[0][slot].size() > 1) {
+                stable_sort(slots[0][slot].begin(), slots[0][slot].end(), [](const Event & a, const Event & b) {
+                    return CompareEvent()(b, a);
+                });
+            }
+            drainingSorted = true;
+        }
+    }
+
+    // Puts an event for the current time, at or before the current key, into the slot being
+    // drained. The slot's undrained events stay in CompareEvent order; an unsorted one is
+    // sorted by settle anyway. No level 0 slot can come before it, since level 0 holds only keys
+    // from current on.
+    void joinDrainingSlot(const Event & e) {
+        int slot = digitOf(current, 0);
+        vector<Event> & events = slots[0][slot];
+        if (events.empty()) {
+            drained = 0;
+            drainingSorted = true;
+            occupied[0][slot / 64] |= uint64_t{1} << (slot % 64);
+        }
+        if (drainingSorted) {
+            auto position = upper_bound(events.begin() + drained, events.end(), e, [](const Event & a, const Event & b) {
+                return CompareEvent()(b, a);
+            });
+            events.insert(position, e);
+        } else {
+            events.push_back(e);
+        }
+    }
+
+public:
+    TimingWheelEventQueue() : occupied{}, current(0), drained(0), drainingSorted(false), eventCount(0) {}
+
+    bool empty() const {
+        return eventCount == 0;
+    }
+
+    size_t size() const {
+        return eventCount;
+    }
+
+    void push(const Event & e) {
+        Key key = keyOf(e);
+        if (key > current) {
+            place(e, key);
+        } else if (key >> 2 == current >> 2) {
+            joinDrainingSlot(e);
+        } else {
+            throw invalid_argument("Cannot schedule an event before the current time.");
+        }
+        ++eventCount;
+    }
+
+    const Event & top() {
+        assert(!empty());
+        settle();
+        return slots[0][digitOf(current, 0)][drained];
+    }
+
+    void pop() {
+        assert(!empty());
+        settle();
+        int slot = digitOf(current, 0);
+        if (++drained == slots[0][slot].size()) {
+            slots[0][slot].clear();
+            occupied[0][slot / 64] &= ~(uint64_t{1} << (slot % 64));
+            drained = 0;
+            drainingSorted = false;
+        }
+        if (--eventCount == 0) {
+            current = 0; // nothing left to be earlier than
+        }
+    }
 };
 
-// A line of customers waiting to be served by a teller.
-using BankLine = queue<Customer>;
-// The event priority queue used by the simulation.
-using EventQueue = priority_queue<Event, vector<Event>, CompareEvent>;
+// Runs the same pushes through both queues the way a simulation does: each event popped may bring
+// in events at its own time or later, of any kind, with at most one arrival waiting at a time.
+// Departures and reneges are unique by teller and ticket, so the order is fully determined.
+TEST_CASE("testing the timing wheel against the binary heap") {
+    mt19937 generator(44);
+    for (int trial = 0; trial < 200; ++trial) {
+        HeapEventQueue heap;
+        TimingWheelEventQueue wheel;
+        auto pushBoth = [&](const Event & e) {
+            heap.push(e);
+            wheel.push(e);
+        };
+        size_t nextTeller = 0;
+        uint64_t nextTicket = 0;
+        pushBoth(ArrivalEvent{static_cast<Time>(generator() % 10), 1});
+        int arrivalsLeft = 200;
+        bool allMatch = true;
+        while (!heap.empty()) {
+            allMatch = allMatch && !wheel.empty() && heap.size() == wheel.size();
+            Event expected = heap.top();
+            Event actual = wheel.top();
+            allMatch = allMatch && expected.index() == actual.index() &&
+                       get_event_time(expected) == get_event_time(actual);
+            if (holds_alternative<DepartureEvent>(expected)) {
+                allMatch = allMatch && get<DepartureEvent>(expected).tellerIndex == get<DepartureEvent>(actual).tellerIndex;
+            } else if (holds_alternative<RenegeEvent>(expected)) {
+                allMatch = allMatch && get<RenegeEvent>(expected).ticket == get<RenegeEvent>(actual).ticket;
+            }
+            heap.pop();
+            wheel.pop();
+
+            Time now = get_event_time(expected);
+            // Half a new event per event on average, so the queue drains once arrivals stop.
+            for (int i = generator() % 4 == 0 ? 2 : 0; i > 0; --i) {
+                // Zero delays put same-time departures and reneges behind an event already out.
+                Time delay = generator() % 4 == 0 ? 0 : static_cast<Time>(generator() % 600);
+                if (generator() % 2 == 0) {
+                    pushBoth(DepartureEvent{now + delay, nextTeller++});
+                } else {
+                    pushBoth(RenegeEvent{now + delay, 0, 0, nextTicket++});
+                }
+            }
+            if (holds_alternative<ArrivalEvent>(expected) && arrivalsLeft-- > 0) {
+                pushBoth(ArrivalEvent{now + static_cast<Time>(generator() % 3), 1});
+            }
+        }
+        CHECK(allMatch);
+        CHECK(wheel.empty());
+    }
+
+    TimingWheelEventQueue wheel;
+    wheel.push(ArrivalEvent{10, 1});
+    wheel.push(DepartureEvent{20, 0});
+    wheel.pop();
+    CHECK_THROWS_AS(wheel.push(DepartureEvent{9, 0}), invalid_argument);
+}
+
 // A list of arrival events used to start the simulation.
 using SimulationInput = vector<ArrivalEvent>;
 
+// Gives the next arrival, or nullopt when there are no more. Arrivals must come in time order.
+using ArrivalStream = function<optional<ArrivalEvent>()>;
+// Starts a new stream over the same arrivals, once for each simulation run.
+using ArrivalSource = function<ArrivalStream()>;
+
+// Streams the arrivals of input in place. The input must be in time order and outlive every run.
+ArrivalSource arrivalsFrom(const SimulationInput & input) {
+    return [&input]() -> ArrivalStream {
+        return [&input, next = size_t{0}]() mutable -> optional<ArrivalEvent> {
+            if (next == input.size()) {
+                return nullopt;
+            }
+            return input[next++];
+        };
+    };
+}
+
+// Streams arrivals from a text file of "arrivalTime transactionTime" pairs, reopening it for each
+// run, so a trace never has to fit in memory.
+ArrivalSource arrivalsFromFile(const string & path) {
+    return [path]() -> ArrivalStream {
+        auto file = make_shared<ifstream>(path);
+        if (!*file) {
+            throw runtime_error("Cannot open arrivals file " + path);
+        }
+        return [file, path]() -> optional<ArrivalEvent> {
+            ArrivalEvent arrival{};
+            if (*file >> arrival.arrivalTime >> arrival.transactionTime) {
+                return arrival;
+            }
+            if (!file->eof()) {
+                throw runtime_error("Malformed arrival in " + path);
+            }
+            return nullopt;
+        };
+    };
+}
+
+// EventQueue is the scheduling policy. It needs empty, push, top and pop like std::priority_queue,
+// with top giving the earliest event.
+//
+// Arrivals are streamed, not loaded into the event queue up front: the queue holds just the next
+// arrival, one departure per busy teller and one renege per customer who may run out of patience,
+// and each arrival taken out brings in the one after it. When a departure and an arrival happen at
+// the same time, the departure goes first.
+//
+// The discipline picks one bank line or a line per teller and when customers balk. A renege is
+// never taken out of the event queue: a customer who is served first leaves the line, and the
+// renege finds nobody with its ticket when it comes up.
+template<class EventQueue = HeapEventQueue>
 class BankSim3000 {
 private:
     // Input is stored locally to help restart the simulation for multiple tellers.
     SimulationInput simulationInput;
-    // The event queue. Initially this is loaded with the simulation input.
+    // Where arrivals come from when the simulation wasn't given simulationInput.
+    ArrivalSource arrivalSource;
+    // The next arrival and pending departures. Initially this is empty.
     EventQueue eventQueue;
-    // The bank line. Initially this is empty.
-    BankLine bankLine;
+    // How customers line up.
+    ServiceDiscipline discipline;
+    // The bank line, or one line per teller. Initially these are empty.
+    vector<BankLine> bankLines;
+    // With a line per teller, the lines by length and teller, so the shortest is on top. A line's
+    // handle is its teller's index.
+    IndexedHeap<pair<size_t, TellerIndex>, TellerIndex> linesByLength;
+    // Customers in all the lines.
+    size_t waitingCount;
+    // Given out to customers as they join a line.
+    uint64_t nextTicket;
 
     // One teller simulation state for each teller.
     vector<Teller> tellers;
+    // The tellers who are available, kept in step with their startWork and stopWork calls.
+    FreeTellerSet freeTellers;
+    // Wait, sojourn and line length statistics for the current run.
+    SimulationMetrics metrics;
+    // When the bank line last changed length.
+    Time lastLineChange;
+    bool anyArrivals;
+
+    // Records a customer whose transaction starts now.
+    void recordService(Time currentTime, const ArrivalEvent & arrivalEvent) {
+        Time waitTime = currentTime - arrivalEvent.arrivalTime;
+        metrics.waitTimes.record(waitTime);
+        metrics.sojournTimes.record(static_cast<long long>(waitTime) + arrivalEvent.transactionTime);
+        vector<LogHistogram> & byPriority = metrics.waitTimesByPriority;
+        if (byPriority.size() <= static_cast<size_t>(arrivalEvent.priority)) {
+            byPriority.resize(arrivalEvent.priority + 1);
+        }
+        byPriority[arrivalEvent.priority].record(waitTime);
+    }
+
+    // Records how long the lines kept their current total length. Called just before it changes.
+    void recordBankLine(Time currentTime) {
+        metrics.queueLengths.record(static_cast<long long>(waitingCount), currentTime - lastLineChange);
+        lastLineChange = currentTime;
+    }
+
+    // The line a teller serves.
+    size_t lineOf(TellerIndex tellerIndex) {
+        return discipline.linePerTeller ? tellerIndex : 0;
+    }
+
+    // The line a customer who finds every teller busy joins.
+    size_t lineToJoin() {
+        return discipline.linePerTeller ? linesByLength.top() : 0;
+    }
+
+    // Keeps linesByLength in step after a customer joins or leaves a line.
+    void lineLengthChanged(size_t line) {
+        if (discipline.linePerTeller) {
+            linesByLength.updateKey(line, {bankLines[line].size(), line});
+        }
+    }
 
     // Resets the tellers vector to the requested size and initialized to the default constructor.
     void resetTellers(size_t tellerCount) {
@@ -152,27 +1013,31 @@ private:
         for(size_t i=0; i<tellerCount; ++i) {
             tellers.emplace_back();
         }
+
+        freeTellers = FreeTellerSet(tellerCount);
     }
 
-    // Clears the bank line.
+    // Clears the bank lines, making one per teller if the discipline asks for it.
     void clearBankLine() {
-        assert(bankLine.empty()); // It should already be cleared after a complete simulation run.
-        while(!bankLine.empty()) {
-            bankLine.pop();
+        assert(waitingCount == 0); // They should already be cleared after a complete simulation run.
+        size_t lineCount = discipline.linePerTeller ? tellers.size() : 1;
+        bankLines.assign(lineCount, BankLine());
+        linesByLength.clear();
+        if (discipline.linePerTeller) {
+            for (TellerIndex tellerIndex = 0; tellerIndex < lineCount; ++tellerIndex) {
+                linesByLength.push({0, tellerIndex}, tellerIndex);
+            }
         }
+        waitingCount = 0;
+        nextTicket = 0;
     }
 
-    // Clears the event queue and initializes it to our input data.
+    // Clears the event queue.
     void setupEventQueue() {
         assert(eventQueue.empty()); // Should also already be empty after a complete simulation.
         while(!eventQueue.empty()) {
             eventQueue.pop();
         }
-
-        // TODO: Load all the input data from simulationInput into the event priority queue.
-        for (const auto& arrival : simulationInput){
-            eventQueue.push(arrival);
-        }
     }
 
     // Sets up the simulation for the given number of tellers.
@@ -180,22 +1045,24 @@ private:
         if(tellerCount < MIN_TELLERS) {
             throw invalid_argument("Teller count must >= 1");
         }
-        if(tellerCount > MAX_TELLERS) {
-            throw invalid_argument("Teller count must be <= 5");
-        }
 
         setupEventQueue();
 
         resetTellers(tellerCount);
 
         clearBankLine();
+
+        metrics = SimulationMetrics();
+        anyArrivals = false;
     }
 
-    // Processes either an arrival or a departure event.
+    // Processes an arrival, departure or renege event.
     void processEvent(Time currentTime, const Event & e) {
         if(holds_alternative<ArrivalEvent>(e)) {
             ArrivalEvent arrivalEvent = get<ArrivalEvent>(e);
             processArrival(currentTime, arrivalEvent);
+        } else if(holds_alternative<RenegeEvent>(e)) {
+            processRenege(currentTime, get<RenegeEvent>(e));
         } else {
             assert(holds_alternative<DepartureEvent>(e));
             DepartureEvent departureEvent = get<DepartureEvent>(e);
@@ -204,22 +1071,34 @@ private:
     }
 
     // Helper used by processArrival.
-    // Returns the index of an available teller or nullopt if all are busy.
+    // Returns the index of the lowest numbered available teller or nullopt if all are busy.
     optional<size_t> searchAvailableTellers() {
-        for(size_t i=0; i<tellers.size(); ++i) {
-            if(tellers[i].isAvailable()) {
-                return i;
-            }
+        if(freeTellers.empty()) {
+            return nullopt;
         }
-        return nullopt;
+        return freeTellers.lowest();
     }
 
     // Process arrival events.
     //
     // If teller is not available or the bank line is full then we're busy,
-    // place customer at the end of the bank line. Otherwise, we weren't
-    // busy so start teller work and add a new departure event to the event queue.
+    // place customer in the bank line, unless it is too long for them, and schedule
+    // their renege if they are impatient. Otherwise, we weren't busy so start
+    // teller work and add a new departure event to the event queue.
     void processArrival(Time currentTime, const ArrivalEvent& arrivalEvent) {
+        if (arrivalEvent.priority < 0 || arrivalEvent.priority > MAX_PRIORITY) {
+            throw invalid_argument("Priority must be between 0 and " + to_string(MAX_PRIORITY) + ".");
+        }
+        if (arrivalEvent.patience < 0) {
+            throw invalid_argument("Patience must not be negative.");
+        }
+        if (!anyArrivals) {
+            anyArrivals = true;
+            metrics.startTime = currentTime;
+            metrics.endTime = currentTime;
+            lastLineChange = currentTime;
+        }
+
         auto teller_index_opt = searchAvailableTellers();
 
         bool is_teller_available = teller_index_opt.has_value();
@@ -228,12 +1107,53 @@ private:
         if (is_teller_available) {
             TellerIndex tellerIndex = teller_index_opt.value();
             tellers[tellerIndex].startWork(currentTime);
+            freeTellers.markBusy(tellerIndex);
 
+            recordService(currentTime, arrivalEvent);
             Time departureTime = currentTime + arrivalEvent.transactionTime;
             eventQueue.push(DepartureEvent{departureTime, tellerIndex});
         } else {
-            bankLine.push(Customer{arrivalEvent});
+            size_t line = lineToJoin();
+            if (bankLines[line].size() >= discipline.balkingLength) {
+                ++metrics.customersBalked;
+                return;
+            }
+            // No patience at all: they leave instead of joining the line.
+            if (arrivalEvent.patience == 0) {
+                ++metrics.customersReneged;
+                return;
+            }
+
+            recordBankLine(currentTime);
+            uint64_t ticket = nextTicket++;
+            size_t place = bankLines[line].push(PlaceInLine{arrivalEvent.priority, ticket}, Customer{arrivalEvent});
+            ++waitingCount;
+            lineLengthChanged(line);
+
+            // Patience that runs past the last representable time never runs out.
+            long long renegeTime = static_cast<long long>(currentTime) + arrivalEvent.patience;
+            if (arrivalEvent.patience != numeric_limits<Time>::max() && renegeTime <= numeric_limits<Time>::max()) {
+                eventQueue.push(RenegeEvent{static_cast<Time>(renegeTime), static_cast<uint32_t>(line),
+                                            static_cast<uint32_t>(place), ticket});
+            }
+        }
+    }
+
+    // Process renege events.
+    //
+    // If the customer is still waiting, they leave the line. If they were served
+    // first, their place may be empty or taken by someone with a later ticket.
+    void processRenege(Time currentTime, const RenegeEvent& renegeEvent) {
+        BankLine & line = bankLines[renegeEvent.line];
+        if (!line.contains(renegeEvent.place) || line.keyOf(renegeEvent.place).ticket != renegeEvent.ticket) {
+            return;
         }
+
+        recordBankLine(currentTime);
+        line.erase(renegeEvent.place);
+        --waitingCount;
+        lineLengthChanged(renegeEvent.line);
+        ++metrics.customersReneged;
     }
 
     // Process departure events.
@@ -247,15 +1167,19 @@ private:
         // First, mark the *current* transaction as complete and accumulate its busy time.
         // This is crucial to correctly account for the time spent on the just-finished customer.
         tellers[tellerIndex].stopWork(currentTime); // This calls stopWork to record time for completed customer
+        metrics.endTime = currentTime;
 
         // TODO: Process a departure event. Don't forget to set a teller to not-working if they are.
-        if (bankLine.empty()) {
-            // This is a NO-OP
-         
+        size_t line = lineOf(tellerIndex);
+        if (bankLines[line].empty()) {
+            freeTellers.markFree(tellerIndex);
         } else {
          
-            Customer nextCustomer = bankLine.front();
-            bankLine.pop();
+            recordBankLine(currentTime);
+            Customer nextCustomer = bankLines[line].pop();
+            --waitingCount;
+            lineLengthChanged(line);
+            recordService(currentTime, nextCustomer.arrivalEvent);
 
             // Teller starts working on new customer
             tellers[tellerIndex].startWork(currentTime); 
@@ -268,12 +1192,28 @@ private:
 
     // Runs the simulation.
     void runSimulation() {
+        ArrivalStream arrivals = arrivalSource ? arrivalSource() : arrivalsFrom(simulationInput)();
+        Time lastArrivalTime = numeric_limits<Time>::min();
+        auto scheduleNextArrival = [&]() {
+            if(optional<ArrivalEvent> nextArrival = arrivals()) {
+                if(nextArrival->arrivalTime < lastArrivalTime) {
+                    throw invalid_argument("Arrivals must be in time order.");
+                }
+                lastArrivalTime = nextArrival->arrivalTime;
+                eventQueue.push(nextArrival.value());
+            }
+        };
+
+        scheduleNextArrival();
         while(!eventQueue.empty()) {
             // Remove event.
             Event e = eventQueue.top();
             eventQueue.pop();
 
             processEvent(get_event_time(e), e);
+            if(holds_alternative<ArrivalEvent>(e)) {
+                scheduleNextArrival();
+            }
         }
     }
 
@@ -285,33 +1225,662 @@ private:
             return teller.elapsedTimeWorking();
         });
 
-        return SimulationResults {elapsedTimeBusy};
+        // The last event may be a renege after the last departure.
+        if (anyArrivals && metrics.endTime > lastLineChange) {
+            recordBankLine(metrics.endTime);
+        }
+        return SimulationResults {elapsedTimeBusy, std::move(metrics)};
     }
 
 public:
 
-    BankSim3000(SimulationInput simulationInput) : simulationInput(simulationInput) { }
+    // Takes over the input, putting it in time order if it isn't already.
+    BankSim3000(SimulationInput simulationInput, ServiceDiscipline discipline = ServiceDiscipline())
+            : simulationInput(std::move(simulationInput)), discipline(discipline), waitingCount(0), nextTicket(0),
+              lastLineChange(0), anyArrivals(false) {
+        stable_sort(this->simulationInput.begin(), this->simulationInput.end(),
+                    [](const ArrivalEvent & a, const ArrivalEvent & b) { return a.arrivalTime < b.arrivalTime; });
+    }
 
-    Time maxTellerBusyTime(size_t tellerCount) {
+    // Streams arrivals from a new stream on each run.
+    BankSim3000(ArrivalSource arrivalSource, ServiceDiscipline discipline = ServiceDiscipline())
+            : arrivalSource(std::move(arrivalSource)), discipline(discipline), waitingCount(0), nextTicket(0),
+              lastLineChange(0), anyArrivals(false) { }
+
+    SimulationResults simulate(size_t tellerCount) {
         setupSimulation(tellerCount);
 
         runSimulation();
 
-        return gatherResults().maxTellerBusyTime();
+        return gatherResults();
+    }
+
+    Time maxTellerBusyTime(size_t tellerCount) {
+        return simulate(tellerCount).maxTellerBusyTime();
     }
 };
 
-int main() {
+template<class EventQueue>
+SimulationResults simulateWith(const SimulationInput & input, size_t tellerCount,
+                               ServiceDiscipline discipline = ServiceDiscipline()) {
+    BankSim3000<EventQueue> bankSim(input, discipline);
+    return bankSim.simulate(tellerCount);
+}
+
+TEST_CASE("testing the bank simulation") {
+    SimulationInput SimulationInput00 = {{20, 6}, {22, 4}, {23, 2}, {30, 3}};
+    Time expected[] = {15, 11, 9, 9, 9};
+    for (size_t tellerCount = 1; tellerCount <= 5; ++tellerCount) {
+        CHECK(simulateWith<HeapEventQueue>(SimulationInput00, tellerCount).maxTellerBusyTime() == expected[tellerCount - 1]);
+        CHECK(simulateWith<TimingWheelEventQueue>(SimulationInput00, tellerCount).maxTellerBusyTime() == expected[tellerCount - 1]);
+    }
+
+    SimulationResults results = simulateWith<HeapEventQueue>(SimulationInput00, 1);
+    CHECK(results.metrics.waitTimes.mean() == doctest::Approx(13.0 / 4)); // 0, 4, 7 and 2
+    CHECK(results.metrics.sojournTimes.max() == 9);
+    CHECK(results.metrics.startTime == 20);
+    CHECK(results.metrics.endTime == 35);
+    CHECK(results.utilization() == doctest::Approx(1.0));
+
+    // Zero-length transactions depart at their arrival time.
+    SimulationInput zeroLength = {{5, 0}, {5, 3}, {6, 0}};
+    CHECK(simulateWith<HeapEventQueue>(zeroLength, 2).totalTellerBusyTime() == 3);
+    CHECK(simulateWith<TimingWheelEventQueue>(zeroLength, 2).totalTellerBusyTime() == 3);
+
+    CHECK_THROWS_AS(simulateWith<HeapEventQueue>(SimulationInput00, 0), invalid_argument);
+    CHECK_THROWS_AS(simulateWith<HeapEventQueue>({{0, 1, MAX_PRIORITY + 1}}, 1), invalid_argument);
+    CHECK_THROWS_AS(simulateWith<HeapEventQueue>({{0, 1, 0, -1}}, 1), invalid_argument);
+    SimulationInput outOfOrderInput = {{5, 1}, {4, 1}};
+    BankSim3000 outOfOrder(arrivalsFrom(outOfOrderInput));
+    CHECK_THROWS_AS(outOfOrder.simulate(1), invalid_argument);
+}
+
+TEST_CASE("testing service disciplines") {
+    // The second customer gives up at 4, before the teller is free at 10.
+    SimulationResults results = simulateWith<HeapEventQueue>({{0, 10}, {1, 5, 0, 3}, {2, 3}}, 1);
+    CHECK(results.metrics.customersReneged == 1);
+    CHECK(results.metrics.waitTimes.count() == 2);
+    CHECK(results.metrics.waitTimes.max() == 8);
+
+    // Patience that runs out just as the teller comes free is enough.
+    results = simulateWith<TimingWheelEventQueue>({{0, 5}, {1, 2, 0, 4}}, 1);
+    CHECK(results.metrics.customersReneged == 0);
+    CHECK(results.metrics.waitTimes.max() == 4);
+
+    // The VIP who came last is served first.
+    results = simulateWith<HeapEventQueue>({{0, 10}, {1, 5}, {2, 5, 1}}, 1);
+    CHECK(results.metrics.waitTimesByPriority.at(1).max() == 8);
+    CHECK(results.metrics.waitTimesByPriority.at(0).max() == 14);
+
+    ServiceDiscipline balking;
+    balking.balkingLength = 1;
+    results = simulateWith<HeapEventQueue>({{0, 10}, {1, 1}, {2, 1}}, 1, balking);
+    CHECK(results.metrics.customersBalked == 1);
+    CHECK(results.metrics.waitTimes.count() == 2);
+
+    // With a line per teller, the short transactions queued behind teller 0 wait for it even
+    // though teller 1 comes free at 2.
+    ServiceDiscipline shortestLine;
+    shortestLine.linePerTeller = true;
+    results = simulateWith<HeapEventQueue>({{0, 10}, {0, 2}, {1, 1}, {1, 1}, {1, 1}}, 2, shortestLine);
+    CHECK(results.elapsedTimeBusy == vector<Time>{12, 3});
+    CHECK(results.metrics.waitTimes.max() == 10);
+    results = simulateWith<HeapEventQueue>({{0, 10}, {0, 2}, {1, 1}, {1, 1}, {1, 1}}, 2);
+    CHECK(results.elapsedTimeBusy == vector<Time>{10, 5});
+}
+
+// Both event queues must give the same results for any input, including ties and zero-length
+// transactions that depart at their arrival time.
+TEST_CASE("testing that both event queues simulate the same") {
+    mt19937 generator(47);
+    bool allMatch = true;
+    bool allAccounted = true;
+    for (int trial = 0; trial < 500; ++trial) {
+        SimulationInput input;
+        Time arrivalTime = 0;
+        for (int i = generator() % 60; i >= 0; --i) {
+            arrivalTime += generator() % 3;
+            ArrivalEvent arrival{arrivalTime, static_cast<Time>(generator() % 4)};
+            if (generator() % 4 == 0) {
+                arrival.priority = generator() % 3;
+            }
+            if (generator() % 3 == 0) {
+                arrival.patience = generator() % 5;
+            }
+            input.push_back(arrival);
+        }
+        ServiceDiscipline discipline;
+        discipline.linePerTeller = trial % 2 == 1;
+        if (trial % 3 == 0) {
+            discipline.balkingLength = 2;
+        }
+        size_t tellerCount = 1 + trial % 4;
+        SimulationResults heap = simulateWith<HeapEventQueue>(input, tellerCount, discipline);
+        SimulationResults wheel = simulateWith<TimingWheelEventQueue>(input, tellerCount, discipline);
+        allMatch = allMatch && heap.elapsedTimeBusy == wheel.elapsedTimeBusy &&
+                   heap.metrics.waitTimes.mean() == wheel.metrics.waitTimes.mean() &&
+                   heap.metrics.customersReneged == wheel.metrics.customersReneged &&
+                   heap.metrics.customersBalked == wheel.metrics.customersBalked &&
+                   heap.meanQueueLength() == wheel.meanQueueLength();
+        allAccounted = allAccounted && heap.metrics.waitTimes.count() + heap.metrics.customersReneged +
+                                       heap.metrics.customersBalked == input.size();
+    }
+    CHECK(allMatch);
+    CHECK(allAccounted);
+}
+
+// ***** PARALLEL SWEEPS *****
+
+// Calls work(0) ... work(jobCount - 1) on threadCount threads, each taking the next job index from
+// a shared counter, and waits for all of them. The first exception thrown by a job is rethrown.
+void runJobs(size_t jobCount, size_t threadCount, const function<void(size_t)> & work) {
+    atomic<size_t> nextJob{0};
+    exception_ptr firstError;
+    mutex errorLock;
+    auto worker = [&]() {
+        for (size_t job = nextJob++; job < jobCount; job = nextJob++) {
+            try {
+                work(job);
+            } catch (...) {
+                lock_guard<mutex> guard(errorLock);
+                if (!firstError) {
+                    firstError = current_exception();
+                }
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 1; i < min(threadCount, jobCount); ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread & t : threads) {
+        t.join();
+    }
+    if (firstError) {
+        rethrow_exception(firstError);
+    }
+}
+
+size_t defaultThreadCount() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+// One row of a sweep: the results of simulating the input for seed with tellerCount tellers.
+struct SweepResult {
+    size_t tellerCount;
+    unsigned seed;
+    SimulationResults results;
+};
+
+// Simulates every combination of teller count and seed, where makeInput(seed) gives the customers
+// for a seed. Each run gets its own BankSim3000, so runs share nothing but their read-only input
+// and go in parallel. The table is ordered by seed, then by teller count, as given.
+template<class EventQueue = HeapEventQueue>
+vector<SweepResult> sweepTellerCounts(const vector<size_t> & tellerCounts, const vector<unsigned> & seeds,
+                                      const function<SimulationInput(unsigned)> & makeInput,
+                                      size_t threadCount = defaultThreadCount()) {
+    vector<SimulationInput> inputs(seeds.size());
+    runJobs(seeds.size(), threadCount, [&](size_t i) {
+        inputs[i] = makeInput(seeds[i]);
+    });
+
+    vector<optional<SweepResult>> rows(seeds.size() * tellerCounts.size());
+    runJobs(rows.size(), threadCount, [&](size_t job) {
+        size_t seedIndex = job / tellerCounts.size();
+        size_t tellerCount = tellerCounts[job % tellerCounts.size()];
+        BankSim3000<EventQueue> bankSim(arrivalsFrom(inputs[seedIndex]));
+        rows[job] = SweepResult{tellerCount, seeds[seedIndex], bankSim.simulate(tellerCount)};
+    });
+
+    vector<SweepResult> table;
+    table.reserve(rows.size());
+    for (optional<SweepResult> & row : rows) {
+        table.push_back(std::move(row.value()));
+    }
+    return table;
+}
+
+// Sweeps teller counts over one fixed input, which must be in time order.
+template<class EventQueue = HeapEventQueue>
+vector<SweepResult> sweepTellerCounts(const vector<size_t> & tellerCounts, const SimulationInput & input,
+                                      size_t threadCount = defaultThreadCount()) {
+    return sweepTellerCounts<EventQueue>(tellerCounts, {0}, [&input](unsigned) { return input; }, threadCount);
+}
+
+// Random arrivals with transactions of 1 to 13 units, coming often enough to keep tellerCount
+// tellers about 93% busy. Each run streams the same arrivals again without storing them.
+ArrivalSource generatedArrivals(size_t customerCount, size_t tellerCount, unsigned seed) {
+    return [=]() -> ArrivalStream {
+        return [=, generator = mt19937(seed), arrivalClock = 0.0, generated = size_t{0}]() mutable
+                -> optional<ArrivalEvent> {
+            if (generated == customerCount) {
+                return nullopt;
+            }
+            ++generated;
+            arrivalClock += exponential_distribution<double>(0.93 * tellerCount / 7.0)(generator);
+            Time transactionTime = uniform_int_distribution<Time>(1, 13)(generator);
+            return ArrivalEvent{static_cast<Time>(arrivalClock), transactionTime};
+        };
+    };
+}
+
+SimulationInput generateBusyDay(size_t customerCount, size_t tellerCount, unsigned seed) {
+    ArrivalStream arrivals = generatedArrivals(customerCount, tellerCount, seed)();
+    SimulationInput input;
+    input.reserve(customerCount);
+    while (optional<ArrivalEvent> arrival = arrivals()) {
+        input.push_back(arrival.value());
+    }
+    return input;
+}
+
+// ***** WORKLOADS AND REPLICATIONS *****
+
+// Draws one random value, such as a transaction time, from its own generator.
+using Sampler = function<double(mt19937_64 &)>;
+
+Sampler exponentialSampler(double mean) {
+    if (!(mean > 0)) {
+        throw invalid_argument("An exponential mean must be positive.");
+    }
+    return [mean](mt19937_64 & generator) { return exponential_distribution<double>(1.0 / mean)(generator); };
+}
+
+// A lognormal with the given mean, where sigma is the spread of its logarithm. Transaction times
+// are often like this: most are short, a few take ages.
+Sampler lognormalSampler(double mean, double sigma) {
+    if (!(mean > 0) || sigma < 0) {
+        throw invalid_argument("A lognormal needs a positive mean and a non-negative sigma.");
+    }
+    double mu = log(mean) - sigma * sigma / 2;
+    return [mu, sigma](mt19937_64 & generator) { return lognormal_distribution<double>(mu, sigma)(generator); };
+}
+
+// Resamples measured values, e.g. transaction times taken from a branch's logs.
+Sampler empiricalSampler(vector<double> observations) {
+    if (observations.empty()) {
+        throw invalid_argument("An empirical distribution needs at least one observation.");
+    }
+    return [observations = std::move(observations)](mt19937_64 & generator) {
+        return observations[uniform_int_distribution<size_t>(0, observations.size() - 1)(generator)];
+    };
+}
+
+// Gives the time of the next arrival after now.
+using ArrivalProcess = function<double(double, mt19937_64 &)>;
+
+// Arrivals separated by independent draws from interarrivalTime.
+ArrivalProcess renewalArrivals(Sampler interarrivalTime) {
+    return [interarrivalTime = std::move(interarrivalTime)](double now, mt19937_64 & generator) {
+        return now + interarrivalTime(generator);
+    };
+}
+
+ArrivalProcess poissonArrivals(double ratePerUnit) {
+    return renewalArrivals(exponentialSampler(1.0 / ratePerUnit));
+}
+
+// Arrivals whose rate changes over time, such as a lunch rush. rate(t) must never exceed
+// peakRate. This is thinning (Lewis and Shedler): candidates come at peakRate and each is kept
+// with probability rate(t) / peakRate.
+ArrivalProcess thinnedArrivals(function<double(double)> rate, double peakRate) {
+    if (!(peakRate > 0)) {
+        throw invalid_argument("The peak arrival rate must be positive.");
+    }
+    return [rate = std::move(rate), peakRate](double now, mt19937_64 & generator) {
+        exponential_distribution<double> gap(peakRate);
+        uniform_real_distribution<double> accept(0.0, peakRate);
+        while (true) {
+            now += gap(generator);
+            double rateNow = rate(now);
+            if (rateNow > peakRate) {
+                throw logic_error("The arrival rate went above its peak.");
+            }
+            if (accept(generator) < rateNow) {
+                return now;
+            }
+        }
+    };
+}
+
+// A daily cycle: the rate swings by amplitude (0 to 1) around meanRate, peaking a quarter of the
+// way through each period.
+ArrivalProcess diurnalArrivals(double meanRate, double amplitude, double period) {
+    if (amplitude < 0 || amplitude > 1 || !(period > 0)) {
+        throw invalid_argument("A diurnal cycle needs an amplitude between 0 and 1 and a positive period.");
+    }
+    auto rate = [=](double t) { return meanRate * (1 + amplitude * sin(2 * numbers::pi * t / period)); };
+    return thinnedArrivals(rate, meanRate * (1 + amplitude));
+}
+
+// The customers of a simulated day: when they come, how long they take and how many there are.
+struct Workload {
+    ArrivalProcess arrivals;
+    Sampler transactionTime;
+    size_t customerCount;
+};
+
+// The seed sequence for one generator of a (seed, stream) pair. seed_seq keeps only the low 32
+// bits of each element, so both 64 bit values go in as two words each.
+seed_seq streamSeed(uint64_t seed, uint64_t stream, uint32_t generatorIndex) {
+    return seed_seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                    static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32), generatorIndex};
+}
+
+// Streams the customers of workload. Arrivals and transaction times draw from separate
+// generators, both seeded from (seed, stream), so every run of a source, and every teller count
+// simulated with it, sees the same customers.
+ArrivalSource workloadArrivals(const Workload & workload, uint64_t seed, uint64_t stream = 0) {
+    return [workload, seed, stream]() -> ArrivalStream {
+        seed_seq arrivalSeed = streamSeed(seed, stream, 0);
+        seed_seq transactionSeed = streamSeed(seed, stream, 1);
+        return [workload, arrivalGenerator = mt19937_64(arrivalSeed), transactionGenerator = mt19937_64(transactionSeed),
+                arrivalClock = 0.0, generated = size_t{0}]() mutable -> optional<ArrivalEvent> {
+            if (generated == workload.customerCount) {
+                return nullopt;
+            }
+            ++generated;
+            arrivalClock = workload.arrivals(arrivalClock, arrivalGenerator);
+            if (arrivalClock >= numeric_limits<Time>::max()) {
+                throw overflow_error("The workload ran past the last representable time.");
+            }
+            // Every transaction takes at least one time unit.
+            double transactionTime = round(workload.transactionTime(transactionGenerator));
+            Time wholeTransactionTime = static_cast<Time>(clamp(transactionTime, 1.0, 1e9));
+            return ArrivalEvent{static_cast<Time>(arrivalClock), wholeTransactionTime};
+        };
+    };
+}
+
+// A sample mean with the half width of its 95% confidence interval.
+struct Estimate {
+    double mean;
+    double halfWidth;
+
+    double lower() const {
+        return mean - halfWidth;
+    }
+
+    double upper() const {
+        return mean + halfWidth;
+    }
+};
+
+// The 97.5th percentile of Student's t distribution, exact to three places up to 30 degrees of
+// freedom and from the Cornish-Fisher expansion beyond.
+double studentT975(size_t degreesOfFreedom) {
+    static const double table[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degreesOfFreedom == 0) {
+        return numeric_limits<double>::infinity();
+    }
+    if (degreesOfFreedom <= 30) {
+        return table[degreesOfFreedom - 1];
+    }
+    double z = 1.959964;
+    double n = static_cast<double>(degreesOfFreedom);
+    return z + (z * z * z + z) / (4 * n) + (5 * pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * n * n);
+}
+
+// Treats samples as independent replications, so the interval comes from their spread.
+Estimate estimateMean(const vector<double> & samples) {
+    if (samples.empty()) {
+        throw invalid_argument("An estimate needs at least one sample.");
+    }
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    double mean = sum / samples.size();
+    if (samples.size() == 1) {
+        return Estimate{mean, numeric_limits<double>::infinity()};
+    }
+    double squares = 0;
+    for (double sample : samples) {
+        squares += (sample - mean) * (sample - mean);
+    }
+    double standardError = sqrt(squares / (samples.size() - 1) / samples.size());
+    return Estimate{mean, studentT975(samples.size() - 1) * standardError};
+}
+
+// What a batch of replications says about one teller count.
+struct ReplicationReport {
+    size_t replications;
+    Estimate meanWait;
+    Estimate p99Wait;
+    Estimate meanSojourn;
+    Estimate meanQueueLength;
+    Estimate utilization;
+    // Every replication's wait times together.
+    LogHistogram pooledWaits;
+};
+
+// Runs replications independent copies of workload with tellerCount tellers, in parallel. Copy i
+// uses stream i of seed, so the report is the same for any thread count.
+template<class EventQueue = HeapEventQueue>
+ReplicationReport runReplications(const Workload & workload, size_t tellerCount, size_t replications,
+                                  uint64_t seed, size_t threadCount = defaultThreadCount()) {
+    if (replications == 0) {
+        throw invalid_argument("Run at least one replication.");
+    }
+    vector<optional<SimulationResults>> runs(replications);
+    runJobs(replications, threadCount, [&](size_t i) {
+        BankSim3000<EventQueue> bankSim(workloadArrivals(workload, seed, i));
+        runs[i] = bankSim.simulate(tellerCount);
+    });
+
+    vector<double> meanWaits, p99Waits, meanSojourns, queueLengths, utilizations;
+    LogHistogram pooledWaits;
+    for (optional<SimulationResults> & run : runs) {
+        SimulationMetrics & metrics = run->metrics;
+        meanWaits.push_back(metrics.waitTimes.mean());
+        p99Waits.push_back(static_cast<double>(metrics.waitTimes.percentile(99)));
+        meanSojourns.push_back(metrics.sojournTimes.mean());
+        queueLengths.push_back(run->meanQueueLength());
+        utilizations.push_back(run->utilization());
+        pooledWaits.merge(metrics.waitTimes);
+    }
+    return ReplicationReport{replications, estimateMean(meanWaits), estimateMean(p99Waits),
+                             estimateMean(meanSojourns), estimateMean(queueLengths),
+                             estimateMean(utilizations), std::move(pooledWaits)};
+}
+
+TEST_CASE("testing workloads and replications") {
+    mt19937_64 generator(49);
+    auto sampleMean = [&generator](const Sampler & sampler) {
+        double total = 0;
+        for (int i = 0; i < 100000; ++i) {
+            total += sampler(generator);
+        }
+        return total / 100000;
+    };
+    CHECK(sampleMean(exponentialSampler(5.0)) == doctest::Approx(5.0).epsilon(0.02));
+    CHECK(sampleMean(lognormalSampler(7.0, 0.8)) == doctest::Approx(7.0).epsilon(0.02));
+    CHECK(sampleMean(empiricalSampler({1, 2, 3, 10})) == doctest::Approx(4.0).epsilon(0.02));
+    CHECK_THROWS_AS(empiricalSampler({}), invalid_argument);
+
+    // The same stream gives the same customers, another stream different ones, even when the
+    // seeds or streams differ only in their high 32 bits.
+    Workload day{poissonArrivals(0.5), exponentialSampler(3.0), 500};
+    auto customersOf = [&day](uint64_t seed, uint64_t stream) {
+        SimulationInput input;
+        ArrivalStream arrivals = workloadArrivals(day, seed, stream)();
+        while (optional<ArrivalEvent> arrival = arrivals()) {
+            input.push_back(arrival.value());
+        }
+        return input;
+    };
+    SimulationInput first = customersOf(7, 0);
+    SimulationInput again = customersOf(7, 0);
+    SimulationInput other = customersOf(7, 1);
+    auto sameCustomers = [](const SimulationInput & a, const SimulationInput & b) {
+        return equal(a.begin(), a.end(), b.begin(), b.end(), [](const ArrivalEvent & x, const ArrivalEvent & y) {
+            return x.arrivalTime == y.arrivalTime && x.transactionTime == y.transactionTime;
+        });
+    };
+    CHECK(first.size() == 500);
+    CHECK(sameCustomers(first, again));
+    CHECK_FALSE(sameCustomers(first, other));
+    CHECK_FALSE(sameCustomers(first, customersOf(7 + (uint64_t{1} << 32), 0)));
+    CHECK_FALSE(sameCustomers(other, customersOf(7, 1 + (uint64_t{1} << 32))));
+
+    // Reports don't depend on the number of threads.
+    ReplicationReport oneThread = runReplications(day, 2, 20, 7, 1);
+    ReplicationReport fourThreads = runReplications<TimingWheelEventQueue>(day, 2, 20, 7, 4);
+    CHECK(oneThread.meanWait.mean == fourThreads.meanWait.mean);
+    CHECK(oneThread.meanWait.halfWidth == fourThreads.meanWait.halfWidth);
+    CHECK(oneThread.pooledWaits.count() == fourThreads.pooledWaits.count());
+    CHECK_THROWS_AS(runReplications(day, 2, 0, 7), invalid_argument);
+
+    Estimate estimate = estimateMean({1, 2, 3});
+    CHECK(estimate.mean == 2);
+    CHECK(estimate.halfWidth == doctest::Approx(4.303 / sqrt(3.0)));
+    CHECK(studentT975(31) == doctest::Approx(2.0395).epsilon(0.001));
+}
+
+void printMetrics(SimulationResults & results) {
+    const SimulationMetrics & metrics = results.metrics;
+    cout << "  wait p50 " << metrics.waitTimes.percentile(50) << ", p99 " << metrics.waitTimes.percentile(99)
+         << ", max " << metrics.waitTimes.max() << "; sojourn p99 " << metrics.sojournTimes.percentile(99)
+         << "; mean line " << results.meanQueueLength() << "; utilization " << results.utilization() << endl;
+}
+
+template<class EventQueue>
+void reportEventQueue(const string & name, const ArrivalSource & arrivals, size_t tellerCount) {
+    BankSim3000<EventQueue> bankSim(arrivals);
+    auto start = chrono::steady_clock::now();
+    SimulationResults results = bankSim.simulate(tellerCount);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << name << ": " << elapsed.count() << " s, total teller busy time "
+         << results.totalTellerBusyTime() << endl;
+    printMetrics(results);
+}
+
+// Times a simulation of customerCount streamed customers with each event queue, for a small branch
+// and for a call center.
+void benchmarkEventQueues(size_t customerCount) {
+    for (size_t tellerCount : {size_t{5}, size_t{10000}}) {
+        ArrivalSource arrivals = generatedArrivals(customerCount, tellerCount, 44);
+        cout << "Simulating " << customerCount << " customers with " << tellerCount << " tellers" << endl;
+        reportEventQueue<HeapEventQueue>("Binary heap", arrivals, tellerCount);
+        reportEventQueue<TimingWheelEventQueue>("Timing wheel", arrivals, tellerCount);
+    }
+}
+
+// Times each discipline on the same streamed day, where one customer in ten is a VIP and half
+// give up after waiting 10 to 40 time units.
+void benchmarkDisciplines(size_t customerCount) {
+    const size_t tellerCount = 50;
+    ArrivalSource plainArrivals = generatedArrivals(customerCount, tellerCount, 50);
+    ArrivalSource arrivals = [plainArrivals]() -> ArrivalStream {
+        return [plain = plainArrivals(), generator = mt19937(50)]() mutable -> optional<ArrivalEvent> {
+            optional<ArrivalEvent> arrival = plain();
+            if (arrival) {
+                arrival->priority = generator() % 10 == 0 ? 1 : 0;
+                if (generator() % 2 == 0) {
+                    arrival->patience = uniform_int_distribution<Time>(10, 40)(generator);
+                }
+            }
+            return arrival;
+        };
+    };
+
+    ServiceDiscipline sharedLine;
+    ServiceDiscipline shortestLine;
+    shortestLine.linePerTeller = true;
+    ServiceDiscipline balking;
+    balking.balkingLength = tellerCount;
+    cout << "Simulating " << customerCount << " customers with " << tellerCount << " tellers" << endl;
+    for (auto [name, discipline] : {pair{"One line", sharedLine}, pair{"Shortest of per-teller lines", shortestLine},
+                                    pair{"One line with balking", balking}}) {
+        BankSim3000<TimingWheelEventQueue> bankSim(arrivals, discipline);
+        auto start = chrono::steady_clock::now();
+        SimulationResults results = bankSim.simulate(tellerCount);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        const SimulationMetrics & metrics = results.metrics;
+        cout << name << ": " << elapsed.count() << " s, " << metrics.customersReneged << " reneged, "
+             << metrics.customersBalked << " balked" << endl;
+        cout << "  VIP wait p99 " << metrics.waitTimesByPriority.at(1).percentile(99) << ", others "
+             << metrics.waitTimesByPriority.at(0).percentile(99) << endl;
+        printMetrics(results);
+    }
+}
+
+// Times a capacity-planning sweep of teller counts and seeds on one thread and on all of them.
+void benchmarkSweep(size_t customerCount) {
+    vector<size_t> tellerCounts;
+    for (size_t tellerCount = 40; tellerCount <= 60; tellerCount += 2) {
+        tellerCounts.push_back(tellerCount);
+    }
+    vector<unsigned> seeds = {1, 2, 3, 4};
+    auto makeInput = [customerCount](unsigned seed) { return generateBusyDay(customerCount, 50, seed); };
+
+    cout << "Sweeping " << tellerCounts.size() << " teller counts x " << seeds.size() << " seeds" << endl;
+    Time checksum[2] = {0, 0};
+    size_t threadCounts[2] = {1, defaultThreadCount()};
+    for (int i = 0; i < 2; ++i) {
+        auto start = chrono::steady_clock::now();
+        auto table = sweepTellerCounts<TimingWheelEventQueue>(tellerCounts, seeds, makeInput, threadCounts[i]);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        for (SweepResult & row : table) {
+            checksum[i] += row.results.maxTellerBusyTime();
+        }
+        cout << threadCounts[i] << " threads: " << elapsed.count() << " s" << endl;
+    }
+    assert(checksum[0] == checksum[1]);
+}
+
+// Replicates an 8-hour day at a busy branch, with a lunch rush and lognormal transactions, for a
+// range of teller counts and prints 95% confidence intervals.
+void reportReplications(size_t replications) {
+    // Time is in minutes; about 960 customers a day, taking 7 minutes on average.
+    Workload day{diurnalArrivals(2.0, 0.6, 960.0), lognormalSampler(7.0, 0.8), 960};
+    cout << replications << " replications of a " << day.customerCount << "-customer day" << endl;
+    for (size_t tellerCount = 14; tellerCount <= 20; tellerCount += 2) {
+        ReplicationReport report = runReplications<TimingWheelEventQueue>(day, tellerCount, replications, 49);
+        auto show = [](const Estimate & estimate) {
+            return to_string(estimate.mean) + " +/- " + to_string(estimate.halfWidth);
+        };
+        cout << tellerCount << " tellers: mean wait " << show(report.meanWait) << ", p99 wait "
+             << show(report.p99Wait) << ", utilization " << show(report.utilization) << endl;
+    }
+}
+
+// Pass --test [doctest options] to run the tests, --benchmark [customers] to compare event queues
+// on a large generated day and time a parallel sweep, or --replicate [replications] for a Monte
+// Carlo staffing study.
+int main(int argc, char * argv[]) {
+    if (argc > 1 && string(argv[1]) == "--test") {
+        doctest::Context context;
+        context.applyCommandLine(argc - 1, argv + 1);
+        return context.run();
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        size_t customerCount = argc > 2 ? stoul(argv[2]) : 10000000;
+        benchmarkEventQueues(customerCount);
+        benchmarkDisciplines(customerCount);
+        benchmarkSweep(customerCount / 10);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--replicate") {
+        reportReplications(argc > 2 ? stoul(argv[2]) : 100);
+        return 0;
+    }
+
     // Do not change the input.
     SimulationInput SimulationInput00 = {{20, 6}, {22, 4}, {23, 2}, {30, 3}};
 
-    BankSim3000 bankSim(SimulationInput00);
+    // Each teller count runs in its own simulation, in parallel.
+    vector<SweepResult> table = sweepTellerCounts({1, 2, 3, 4, 5}, SimulationInput00);
 
-    cout << "Time waiting with 1 teller: " << bankSim.maxTellerBusyTime(1) << endl;
-    cout << "Time waiting with 2 tellers: " << bankSim.maxTellerBusyTime(2) << endl;
-    cout << "Time waiting with 3 tellers: " << bankSim.maxTellerBusyTime(3) << endl;
-    cout << "Time waiting with 4 tellers: " << bankSim.maxTellerBusyTime(4) << endl;
-    cout << "Time waiting with 5 tellers: " << bankSim.maxTellerBusyTime(5) << endl;
+    for (SweepResult & row : table) {
+        cout << "Time waiting with " << row.tellerCount << (row.tellerCount == 1 ? " teller: " : " tellers: ")
+             << row.results.maxTellerBusyTime() << endl;
+    }
 
     return 0;
 }
\ No newline at end of file
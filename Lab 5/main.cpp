@@ -8,6 +8,14 @@
 #include <algorithm>
 #include <functional>
 #include <queue>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <limits>
+#include <stdexcept>
+#include <sstream>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
@@ -499,6 +507,15 @@ public:
 
 // *************************** BinarySearchTree ******************************
 
+template<class ItemType>
+class BinarySearchTree;
+
+template<class ItemType>
+void serialize(std::ostream& out, const BinarySearchTree<ItemType>& tree);
+
+template<class ItemType>
+void deserialize(std::istream& in, BinarySearchTree<ItemType>& tree);
+
 template<class ItemType>
 class BinarySearchTreeInterface
 {
@@ -557,6 +574,10 @@ private:
     // both approaches in practice; composition and public inheritance with protected helpers.
     std::shared_ptr<BinaryNode<ItemType>> rootPtr;
 
+    // Saving and loading work on the nodes directly so a loaded tree keeps the saved shape.
+    friend void serialize<ItemType>(std::ostream& out, const BinarySearchTree<ItemType>& tree);
+    friend void deserialize<ItemType>(std::istream& in, BinarySearchTree<ItemType>& tree);
+
     // Places a given new node at its proper position in this binary search tree.
     auto placeNode(std::shared_ptr<BinaryNode<ItemType>> subTreePtr, std::shared_ptr<BinaryNode<ItemType>> newNodePtr) {
         if (subTreePtr == nullptr) {
@@ -758,6 +779,309 @@ void treeSort(ItemType array_in[], int array_size) {
     });
 }
 
+// *************************** Binary Serialization ******************************
+
+// Every stream starts with an 8 byte header: a magic string, a format version, the writer's byte
+// order, the kind of container and a reserved byte. Values are written in the writer's own byte
+// order, so a reader on the same kind of machine copies them straight into place and only a reader
+// on the other kind swaps bytes.
+constexpr char SERIAL_MAGIC[4] = {'D', 'S', 'B', 'F'};
+constexpr std::uint8_t SERIAL_VERSION = 1;
+constexpr std::uint8_t SERIAL_LITTLE_ENDIAN = 1;
+constexpr std::uint8_t SERIAL_BIG_ENDIAN = 2;
+// Lengths and counts come from the data, so readers allocate for at most this many bytes ahead of
+// what they have actually read.
+constexpr std::size_t SERIAL_CHUNK_BYTES = 1 << 16;
+
+enum class SerialKind : std::uint8_t {
+    List = 1,
+    Stack = 2,
+    Tree = 3
+};
+
+inline std::uint8_t hostByteOrder() {
+    const std::uint16_t probe = 1;
+    std::uint8_t firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 1 ? SERIAL_LITTLE_ENDIAN : SERIAL_BIG_ENDIAN;
+}
+
+// The size recorded for an entry type so a reader can refuse data written for another type.
+// Strings are length prefixed and recorded as 0.
+template<class V>
+std::uint32_t serialElementSize() {
+    if constexpr (std::is_same_v<V, std::string>) {
+        return 0;
+    } else {
+        static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable entries and strings can be serialized.");
+        return sizeof(V);
+    }
+}
+
+// Streams values to out behind the header for one container.
+class BinaryWriter {
+private:
+    std::ostream &out;
+
+public:
+    BinaryWriter(std::ostream &out, SerialKind kind) : out(out) {
+        out.write(SERIAL_MAGIC, sizeof(SERIAL_MAGIC));
+        write(SERIAL_VERSION);
+        write(hostByteOrder());
+        write(static_cast<std::uint8_t>(kind));
+        write(std::uint8_t{0}); // reserved, pads the header to 8 bytes
+    }
+
+    template<class V>
+    void write(const V &value) {
+        static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable entries and strings can be serialized.");
+        out.write(reinterpret_cast<const char *>(&value), sizeof(V));
+    }
+
+    void write(const std::string &value) {
+        write<std::uint64_t>(value.size());
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    // Writes count values, as one block when they are trivially copyable.
+    template<class V>
+    void writeArray(const V *values, std::size_t count) {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(V)));
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                write(values[i]);
+            }
+        }
+    }
+
+    template<class V>
+    void writeElementSize() {
+        write(serialElementSize<V>());
+    }
+
+    void finish() {
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Writing serialized data failed.");
+        }
+    }
+};
+
+// Reads values back from in after checking the header. Data that is cut short, of another kind or
+// written for another entry type throws std::runtime_error.
+class BinaryReader {
+private:
+    std::istream &in;
+    bool swapBytes;
+
+    void readBytes(void *destination, std::size_t count) {
+        in.read(static_cast<char *>(destination), static_cast<std::streamsize>(count));
+        if (static_cast<std::size_t>(in.gcount()) != count) {
+            throw std::runtime_error("Serialized data ends early.");
+        }
+    }
+
+    template<class V>
+    static void swapByteOrder(V &value) {
+        if constexpr (std::is_arithmetic_v<V> || std::is_enum_v<V>) {
+            char *bytes = reinterpret_cast<char *>(&value);
+            std::reverse(bytes, bytes + sizeof(V));
+        } else if constexpr (sizeof(V) > 1) {
+            throw std::runtime_error("Cannot change the byte order of a compound entry.");
+        }
+    }
+
+public:
+    BinaryReader(std::istream &in, SerialKind kind) : in(in), swapBytes(false) {
+        char magic[sizeof(SERIAL_MAGIC)];
+        readBytes(magic, sizeof(magic));
+        if (std::memcmp(magic, SERIAL_MAGIC, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not serialized container data.");
+        }
+        if (read<std::uint8_t>() != SERIAL_VERSION) {
+            throw std::runtime_error("Unsupported serialization version.");
+        }
+        std::uint8_t byteOrder = read<std::uint8_t>();
+        if (byteOrder != SERIAL_LITTLE_ENDIAN && byteOrder != SERIAL_BIG_ENDIAN) {
+            throw std::runtime_error("Unknown byte order in serialized data.");
+        }
+        swapBytes = byteOrder != hostByteOrder();
+        if (read<std::uint8_t>() != static_cast<std::uint8_t>(kind)) {
+            throw std::runtime_error("Serialized data holds a different kind of container.");
+        }
+        read<std::uint8_t>();
+    }
+
+    template<class V>
+    V read() {
+        V value{};
+        readInto(value);
+        return value;
+    }
+
+    template<class V>
+    void readInto(V &value) {
+        readBytes(&value, sizeof(V));
+        if (swapBytes) {
+            swapByteOrder(value);
+        }
+    }
+
+    // Grows the string as its bytes arrive, so a corrupt length runs out of input instead of
+    // allocating memory up front.
+    void readInto(std::string &value) {
+        std::uint64_t length = read<std::uint64_t>();
+        if (length > value.max_size()) {
+            throw std::runtime_error("Serialized string is too long.");
+        }
+        value.clear();
+        while (value.size() < length) {
+            std::size_t start = value.size();
+            std::size_t step = static_cast<std::size_t>(std::min<std::uint64_t>(length - start, SERIAL_CHUNK_BYTES));
+            value.resize(start + step);
+            readBytes(&value[start], step);
+        }
+    }
+
+    // Reads count values straight into contiguous storage, as one block when they are trivially
+    // copyable.
+    template<class V>
+    void readArray(V *values, std::size_t count) {
+        if constexpr (std::is_trivially_copyable_v<V>) {
+            readBytes(values, count * sizeof(V));
+            if (swapBytes) {
+                for (std::size_t i = 0; i < count; i++) {
+                    swapByteOrder(values[i]);
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                readInto(values[i]);
+            }
+        }
+    }
+
+    template<class V>
+    void expectElementSize() {
+        if (read<std::uint32_t>() != serialElementSize<V>()) {
+            throw std::runtime_error("Serialized data holds a different entry type.");
+        }
+    }
+
+    // Reads an entry count and checks it fits in an int.
+    int readCount() {
+        std::uint64_t count = read<std::uint64_t>();
+        if (count > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("Serialized entry count is too large.");
+        }
+        return static_cast<int>(count);
+    }
+};
+
+constexpr std::uint8_t TREE_HAS_LEFT = 1;
+constexpr std::uint8_t TREE_HAS_RIGHT = 2;
+
+// Writes the node count and then every node in preorder as a byte saying which children it has
+// followed by its item. The shape is in the stream, so reading it back needs no comparisons.
+template<class ItemType>
+void writeTreeNodes(BinaryWriter& writer, std::shared_ptr<BinaryNode<ItemType>> rootPtr) {
+    writer.write<std::uint64_t>(nodeCountAtTree(rootPtr));
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>> pending;
+    if (rootPtr != nullptr) {
+        pending.push_back(rootPtr);
+    }
+    while (!pending.empty()) {
+        std::shared_ptr<BinaryNode<ItemType>> node = pending.back();
+        pending.pop_back();
+        auto leftPtr = node->getLeftChildPtr();
+        auto rightPtr = node->getRightChildPtr();
+        writer.write<std::uint8_t>((leftPtr != nullptr ? TREE_HAS_LEFT : 0) | (rightPtr != nullptr ? TREE_HAS_RIGHT : 0));
+        writer.write(node->getItem());
+        if (rightPtr != nullptr) {
+            pending.push_back(rightPtr);
+        }
+        if (leftPtr != nullptr) {
+            pending.push_back(leftPtr);
+        }
+    }
+}
+
+// Rebuilds the tree written by writeTreeNodes in one pass. The stack holds the nodes whose right
+// child comes after their left subtree, so it never grows past the height of the tree.
+template<class ItemType>
+std::shared_ptr<BinaryNode<ItemType>> readTreeNodes(BinaryReader& reader) {
+    int count = reader.readCount();
+    if (count == 0) {
+        return nullptr;
+    }
+
+    int nodesRead = 0;
+    auto readNode = [&reader, &nodesRead, count]() {
+        if (nodesRead == count) {
+            throw std::runtime_error("Serialized tree has more nodes than its count.");
+        }
+        nodesRead++;
+        std::uint8_t children = reader.read<std::uint8_t>();
+        if ((children & ~(TREE_HAS_LEFT | TREE_HAS_RIGHT)) != 0) {
+            throw std::runtime_error("Serialized tree node is corrupt.");
+        }
+        auto node = std::make_shared<BinaryNode<ItemType>>(reader.read<ItemType>());
+        return std::make_pair(node, children);
+    };
+
+    std::vector<std::shared_ptr<BinaryNode<ItemType>>> awaitingRight;
+    auto [rootPtr, rootChildren] = readNode();
+    std::shared_ptr<BinaryNode<ItemType>> node = rootPtr;
+    std::uint8_t children = rootChildren;
+    while (true) {
+        if ((children & TREE_HAS_LEFT) != 0) {
+            if ((children & TREE_HAS_RIGHT) != 0) {
+                awaitingRight.push_back(node);
+            }
+            auto [leftPtr, leftChildren] = readNode();
+            node->setLeftChildPtr(leftPtr);
+            node = leftPtr;
+            children = leftChildren;
+        } else {
+            std::shared_ptr<BinaryNode<ItemType>> parentPtr;
+            if ((children & TREE_HAS_RIGHT) != 0) {
+                parentPtr = node;
+            } else if (!awaitingRight.empty()) {
+                parentPtr = awaitingRight.back();
+                awaitingRight.pop_back();
+            } else {
+                break;
+            }
+            auto [rightPtr, rightChildren] = readNode();
+            parentPtr->setRightChildPtr(rightPtr);
+            node = rightPtr;
+            children = rightChildren;
+        }
+    }
+    if (nodesRead != count) {
+        throw std::runtime_error("Serialized tree has fewer nodes than its count.");
+    }
+    return rootPtr;
+}
+
+template<class ItemType>
+void serialize(std::ostream& out, const BinarySearchTree<ItemType>& tree) {
+    BinaryWriter writer(out, SerialKind::Tree);
+    writer.writeElementSize<ItemType>();
+    writeTreeNodes(writer, tree.rootPtr);
+    writer.finish();
+}
+
+// Replaces the contents of tree with the serialized one, node for node. The tree is unchanged if
+// reading fails.
+template<class ItemType>
+void deserialize(std::istream& in, BinarySearchTree<ItemType>& tree) {
+    BinaryReader reader(in, SerialKind::Tree);
+    reader.expectElementSize<ItemType>();
+    tree.rootPtr = readTreeNodes<ItemType>(reader);
+}
+
 // *************************** Unit Tests ******************************
 
 TEST_CASE("testing unordered binary tree with balanced add and removal") {
@@ -1244,4 +1568,65 @@ TEST_CASE("testing in-place tree sort") {
     CHECK_EQ(test_array[1], 2);
     CHECK_EQ(test_array[2], 3);
     CHECK_EQ(test_array[3], 4);
-}
\ No newline at end of file
+}
+
+TEST_CASE("testing binary serialization of the binary search tree") {
+    BinarySearchTree<int> bst;
+    for (int value : {50, 30, 70, 20, 40, 60, 80, 35, 45, 65, 10, 90, 85}) {
+        bst.add(value);
+    }
+    std::stringstream stream;
+    serialize(stream, bst);
+
+    BinarySearchTree<int> loaded(7);
+    deserialize(stream, loaded);
+    std::vector<int> expectedOrder;
+    bst.preorderTraverse([&expectedOrder](int& value) { expectedOrder.push_back(value); });
+    std::vector<int> loadedOrder;
+    loaded.preorderTraverse([&loadedOrder](int& value) { loadedOrder.push_back(value); });
+    CHECK(loadedOrder == expectedOrder); // same preorder means the same shape
+    CHECK_EQ(loaded.getHeight(), bst.getHeight());
+    CHECK(loaded.contains(85));
+    CHECK(loaded.remove(30));
+    CHECK(bst.contains(30)); // the loaded tree shares no nodes with the original
+
+    // A degenerate tree loads without recursion.
+    BinarySearchTree<int> chain;
+    for (int i = 0; i < 2000; i++) {
+        chain.add(i);
+    }
+    std::stringstream chainStream;
+    serialize(chainStream, chain);
+    BinarySearchTree<int> loadedChain;
+    deserialize(chainStream, loadedChain);
+    CHECK_EQ(loadedChain.getNumberOfNodes(), 2000);
+    CHECK_EQ(loadedChain.getHeight(), 1999);
+
+    BinarySearchTree<int> empty;
+    std::stringstream emptyStream;
+    serialize(emptyStream, empty);
+    deserialize(emptyStream, loaded);
+    CHECK(loaded.isEmpty());
+
+    // Cut short or corrupt data throws and leaves the tree alone.
+    std::stringstream truncated(stream.str().substr(0, 30));
+    CHECK_THROWS_AS(deserialize(truncated, bst), std::runtime_error);
+    CHECK_EQ(bst.getNumberOfNodes(), 13);
+    std::string corrupt = stream.str();
+    corrupt[12] = 12; // claim fewer nodes than the shape holds
+    std::stringstream corruptStream(corrupt);
+    CHECK_THROWS_AS(deserialize(corruptStream, bst), std::runtime_error);
+
+    // A corrupt string length runs out of data instead of allocating for it.
+    BinarySearchTree<std::string> words;
+    words.add("mango");
+    words.add("apple");
+    std::stringstream wordStream;
+    serialize(wordStream, words);
+    std::string hugeString = wordStream.str();
+    std::uint64_t hugeLength = std::uint64_t{1} << 62;
+    std::memcpy(&hugeString[21], &hugeLength, sizeof(hugeLength)); // after the root's child flags
+    std::stringstream hugeStringStream(hugeString);
+    CHECK_THROWS_AS(deserialize(hugeStringStream, words), std::runtime_error);
+    CHECK_EQ(words.getNumberOfNodes(), 2);
+}